@@ -9,7 +9,16 @@
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
 
+#include "scene.h"
+#include "mesh_optimizer.h"
+#include "culling.h"
+#include "frame_pacing.h"
+#include "deferred.h"
+#include "asset_reload.h"
+
+#include <cstdio>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -22,11 +31,16 @@ void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
 unsigned int loadTexture(char const *path);
 void renderSphere();
+void setSceneLights(Shader &shader, const SceneData &scene, const glm::mat4 &projection, const glm::mat4 &view);
 
 // --- CONFIGURACIÓN ---
 const unsigned int SCR_WIDTH = 1200;
 const unsigned int SCR_HEIGHT = 600;
 
+// --- RITMO DE FRAMES ---
+const double TARGET_FPS = 0.0;               // L: sin límite / 30 / 60 / 120 / 144 (valor inicial)
+const VsyncMode VSYNC_MODE = VSYNC_ADAPTIVE; // F: apagado / encendido / adaptativo
+
 // --- CÁMARA ---
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 float lastX = SCR_WIDTH / 2.0f;
@@ -40,9 +54,16 @@ float bikeAngle = 0.0f;
 // --- ESTADOS ---
 bool isFirstPerson = false;
 bool vKeyPressed = false;
+bool useGpuCulling = false; // G: culling + multi-draw-indirect en GPU (GL 4.3)
+bool gKeyPressed = false;
+bool vsyncCycleRequested = false;
+bool fKeyPressed = false;
+bool fpsCycleRequested = false;
+bool lKeyPressed = false;
+bool useDeferred = false; // B: G-buffer + volúmenes de luz (forward si no)
+bool bKeyPressed = false;
 
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
+float deltaTime = 0.0f; // Suavizado por FramePacer
 
 // Recursos Globales
 unsigned int planeVAO, planeVBO, floorTexture;
@@ -51,9 +72,6 @@ bool isBraking = false;                // Para saber si la tecla S está presion
 unsigned int cubeVAO = 0, cubeVBO = 0; // Para poder dibujar el cubo
 void renderCube();                     // Prototipo de la función
 
-// LUNA
-glm::vec3 moonPos = glm::vec3(0.0f, 100.0f, 300.0f);
-
 // --- FÍSICA DE LA MOTO ---
 float currentSpeed = 0.0f;
 float acceleration = 15.0f;
@@ -64,12 +82,8 @@ float maxSpeedTurbo = 120.0f;
 
 glm::vec3 oldBikePos;
 
-// Posiciones de las luces REALES (Solo 4 para rendimiento)
-glm::vec3 pointLightPositions[] = {
-    glm::vec3(0.0f, 4.5f, 100.0f),
-    glm::vec3(0.0f, 4.5f, 60.0f),
-    glm::vec3(0.0f, 4.5f, 20.0f),
-    glm::vec3(0.0f, 4.5f, -20.0f)};
+// Luces REALES que admite el shader (Solo 4 para rendimiento)
+const int NR_POINT_LIGHTS = 4;
 
 bool checkCollision(glm::vec3 pos1, float radius1, glm::vec3 pos2, float radius2) {
     float distance = glm::distance(glm::vec2(pos1.x, pos1.z), glm::vec2(pos2.x, pos2.z));
@@ -80,12 +94,22 @@ int main()
 {
     // 1. INICIALIZACIÓN
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // Profundidad 24 + stencil 8: el camino diferido copia su profundidad aquí y usa el stencil
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);
+    glfwWindowHint(GLFW_STENCIL_BITS, 8);
 
+    // 4.3 habilita el culling en GPU; si no hay, el juego sigue en 3.3
     GLFWwindow *window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Night Ride - Final", NULL, NULL);
     if (window == NULL)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Night Ride - Final", NULL, NULL);
+    }
+    if (window == NULL)
     {
         std::cout << "Failed to create GLFW window" << std::endl;
         glfwTerminate();
@@ -107,27 +131,76 @@ int main()
     Shader ourShader("shaders/shader_Examen_B2.vs", "shaders/shader_Examen_B2.fs");
     Shader lampShader("shaders/lamp.vs", "shaders/lamp.fs");
 
+    // Camino diferido: geometría al G-buffer, luces en espacio de pantalla
+    Shader gBufferShader("shaders/shader_Examen_B2.vs", "shaders/gbuffer.fs");
+    Shader deferredLightShader("shaders/deferred_light.vs", "shaders/deferred_light.fs");
+    Shader deferredPointShader("shaders/lamp.vs", "shaders/deferred_point.fs");
+
     // =================================================================================
-    // 3. CARGAR MODELOS
+    // 3. CARGAR ESCENA Y MODELOS
     // =================================================================================
-    stbi_set_flip_vertically_on_load(true);
-
-    // MOTO
-    Model moto("C:/Users/Anna/Documents/Visual Studio 2022/OpenGL/OpenGL/model/motorbike/motorbike.obj");
-
-    // POSTE DE LUZ
-    Model poste("C:/Users/Anna/Documents/Visual Studio 2022/OpenGL/OpenGL/model/poste_de_luz/poste_de_luz.obj");
+    SceneData scene;
+    if (!loadScene("scenes/avenida.scene", scene))
+    {
+        glfwTerminate();
+        return -1;
+    }
 
-    // ARBOL
-    Model arbol("C:/Users/Anna/Documents/Visual Studio 2022/OpenGL/OpenGL/model/arbol/arbol.obj");
+    int motoIndex = findSceneModel(scene, "moto");
+    if (motoIndex < 0)
+    {
+        std::cout << "ERROR ESCENA: falta el modelo 'moto'" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
 
-    // ---> AGREGADO: LA CASA <---
-    Model casaModel("C:/Users/Anna/Documents/Visual Studio 2022/OpenGL/OpenGL/model/casa/casa.obj");
+    // Cada modelo declarado se importa con Assimp y se optimiza (la esfera emisiva no usa Model)
+    stbi_set_flip_vertically_on_load(true);
+    TextureCache modelTextures; // Texturas de los modelos por ruta (compartidas y recargables)
+    std::vector<std::shared_ptr<PackedModel>> models(scene.modelNames.size());
+    AssetReloader assets(window, scene, models, modelTextures); // Recarga en caliente (vigila lo que se carga desde aquí)
+    for (size_t m = 0; m < models.size(); m++)
+    {
+        if (isSceneEsfera(scene, static_cast<uint32_t>(m)))
+            continue;
+        Model source(scene.modelPaths[m]);
+        models[m].reset(new PackedModel(cookModel(source, scene.modelNames[m]), modelTextures));
+        assets.watchModel(static_cast<uint32_t>(m), source);
+        releaseModelBuffers(source);
+    }
+    stbi_set_flip_vertically_on_load(false);
 
-    // TEMPLE
-    Model temple("C:/Users/Anna/Documents/Visual Studio 2022/OpenGL/OpenGL/model/temple/temple.obj");
+    // Transformaciones y esferas envolventes de las instancias (son estáticas)
+    StaticInstances statics;
+    buildStaticInstances(scene, models, statics);
 
-    stbi_set_flip_vertically_on_load(false);
+    // Camino GPU opcional
+    GpuCulling gpuCulling;
+    std::unique_ptr<Shader> indirectShader, gBufferIndirectShader;
+    if (gpuCullingSupported() && gpuCulling.build(scene, statics, models))
+    {
+        indirectShader.reset(new Shader("shaders/shader_Examen_B2_indirect.vs", "shaders/shader_Examen_B2.fs"));
+        gBufferIndirectShader.reset(new Shader("shaders/shader_Examen_B2_indirect.vs", "shaders/gbuffer.fs"));
+        assets.watchShader(*indirectShader, "shaders/shader_Examen_B2_indirect.vs", "shaders/shader_Examen_B2.fs");
+        assets.watchShader(*gBufferIndirectShader, "shaders/shader_Examen_B2_indirect.vs", "shaders/gbuffer.fs");
+    }
+    assets.watchShader(ourShader, "shaders/shader_Examen_B2.vs", "shaders/shader_Examen_B2.fs");
+    assets.watchShader(lampShader, "shaders/lamp.vs", "shaders/lamp.fs");
+    assets.watchShader(gBufferShader, "shaders/shader_Examen_B2.vs", "shaders/gbuffer.fs");
+    assets.watchShader(deferredLightShader, "shaders/deferred_light.vs", "shaders/deferred_light.fs");
+    assets.watchShader(deferredPointShader, "shaders/lamp.vs", "shaders/deferred_point.fs");
+    std::cout << "CULLING: CPU" << (gpuCulling.ready() ? " (G para cambiar a GPU)" : "") << std::endl;
+    std::cout << "ILUMINACION: forward (B para cambiar a diferido)" << std::endl;
+
+    // Tiempos por camino para comparar (se imprimen al cambiar con G o B)
+    // CPU = tiempo de pared (con VSync queda fijo en el refresco); GPU = GL_TIME_ELAPSED
+    double pathTime = 0.0, pathGpuTime = 0.0;
+    int pathFrames = 0, pathGpuFrames = 0;
+    bool lastGpuCulling = useGpuCulling;
+    bool lastDeferred = useDeferred;
+
+    FramePacer framePacer(window, TARGET_FPS, VSYNC_MODE);
+    DeferredRenderer deferred;
     // =================================================================================
 
     // 4. PISO GIGANTE
@@ -152,17 +225,72 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
 
     floorTexture = loadTexture("textures/suelo.png");
+    assets.watchTexture(floorTexture, "textures/suelo.png");
 
     std::cout << "LISTO. SOLO POSTES Y ARBOLES." << std::endl;
 
     while (!glfwWindowShouldClose(window))
     {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        // Esperar GPU / límite de FPS y leer las entradas lo más tarde posible
+        framePacer.beginFrame();
+        glfwPollEvents();
+        framePacer.inputSampled();
+        deltaTime = framePacer.deltaTime();
 
         processInput(window);
 
+        // Assets editados en disco: se cambian aquí, entre frames
+        if (assets.update(glfwGetTime()))
+        {
+            // Un modelo recargado puede cambiar su esfera envolvente y sus lotes
+            buildStaticInstances(scene, models, statics);
+            gpuCulling.rebuildBuffers(scene, statics, models);
+        }
+
+        if (vsyncCycleRequested)
+        {
+            framePacer.cycleVsync();
+            vsyncCycleRequested = false;
+        }
+        if (fpsCycleRequested)
+        {
+            framePacer.cycleTargetFps();
+            fpsCycleRequested = false;
+        }
+
+        if (useGpuCulling && !gpuCulling.ready())
+            useGpuCulling = false;
+        if (useGpuCulling != lastGpuCulling || useDeferred != lastDeferred)
+        {
+            std::cout << (lastDeferred ? "DIFERIDO" : "FORWARD") << " + CULLING " << (lastGpuCulling ? "GPU" : "CPU") << ": frame "
+                      << (pathFrames > 0 ? pathTime * 1000.0 / pathFrames : 0.0) << " ms, GPU "
+                      << (pathGpuFrames > 0 ? pathGpuTime / pathGpuFrames : 0.0) << " ms promedio ("
+                      << pathFrames << " frames)" << std::endl;
+            pathTime = pathGpuTime = 0.0;
+            pathFrames = pathGpuFrames = 0;
+            lastGpuCulling = useGpuCulling;
+            lastDeferred = useDeferred;
+        }
+        pathTime += framePacer.rawDeltaTime();
+        // La medida de GPU llega con MAX_FRAMES_IN_FLIGHT frames de retraso: no mezclar caminos
+        if (pathFrames >= MAX_FRAMES_IN_FLIGHT && framePacer.gpuFrameMs() >= 0.0)
+        {
+            pathGpuTime += framePacer.gpuFrameMs();
+            pathGpuFrames++;
+        }
+        pathFrames++;
+
+        // --- DETECCIÓN DE COLISIÓN ---
+        // Radio moto contra los colliders de la escena
+        for (size_t i = 0; i < scene.colliderRadii.size(); i++)
+        {
+            if (checkCollision(bikePos, 0.8f, scene.colliderCenters[i], scene.colliderRadii[i]))
+            {
+                bikePos = oldBikePos; // Resetear posición
+                currentSpeed = 0.0f;  // Detener moto
+            }
+        }
+
         // --- CÁMARA ---
         if (isFirstPerson)
         {
@@ -200,59 +328,29 @@ int main()
         }
 
         // --- RENDER ---
-        glClearColor(fogColor.x, fogColor.y, fogColor.z, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 6000.0f);
-        glm::mat4 view = camera.GetViewMatrix();
-
-        ourShader.use();
-        ourShader.setVec3("viewPos", camera.Position);
-        ourShader.setFloat("material.shininess", 32.0f);
-        ourShader.setVec3("fogColor", fogColor);
-
-        // LUCES
-        ourShader.setVec3("dirLight.direction", -moonPos);
-        ourShader.setVec3("dirLight.ambient", 0.3f, 0.3f, 0.4f);
-        ourShader.setVec3("dirLight.diffuse", 0.6f, 0.6f, 0.7f);
-        ourShader.setVec3("dirLight.specular", 0.5f, 0.5f, 0.5f);
-
-        for (int i = 0; i < 4; i++)
+        // Diferido: la geometría opaca va al G-buffer; forward: directo a la pantalla
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        bool deferredFrame = useDeferred && deferred.beginGeometryPass(fbWidth, fbHeight);
+        if (!deferredFrame)
         {
-            std::string number = std::to_string(i);
-            ourShader.setVec3("pointLights[" + number + "].position", pointLightPositions[i]);
-            ourShader.setVec3("pointLights[" + number + "].ambient", 0.05f, 0.05f, 0.05f);
-            ourShader.setVec3("pointLights[" + number + "].diffuse", 1.0f, 0.8f, 0.4f);
-            ourShader.setVec3("pointLights[" + number + "].specular", 1.0f, 1.0f, 1.0f);
-            ourShader.setFloat("pointLights[" + number + "].constant", 1.0f);
-            ourShader.setFloat("pointLights[" + number + "].linear", 0.022f);
-            ourShader.setFloat("pointLights[" + number + "].quadratic", 0.0019f);
+            glClearColor(fogColor.x, fogColor.y, fogColor.z, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         }
+        Shader &sceneShader = deferredFrame ? gBufferShader : ourShader;
+        Shader *sceneIndirectShader = deferredFrame ? gBufferIndirectShader.get() : indirectShader.get();
 
-        glm::vec3 bikeFront;
-        bikeFront.x = -sin(glm::radians(bikeAngle));
-        bikeFront.y = 0.0f;
-        bikeFront.z = -cos(glm::radians(bikeAngle));
-        ourShader.setVec3("spotLight.position", bikePos + glm::vec3(0.0f, 1.0f, 0.0f));
-        ourShader.setVec3("spotLight.direction", glm::normalize(bikeFront));
-        ourShader.setVec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
-        ourShader.setVec3("spotLight.diffuse", 5.0f, 5.0f, 5.0f);
-        ourShader.setVec3("spotLight.specular", 5.0f, 5.0f, 5.0f);
-        ourShader.setFloat("spotLight.constant", 1.0f);
-        ourShader.setFloat("spotLight.linear", 0.022f);
-        ourShader.setFloat("spotLight.quadratic", 0.0019f);
-        ourShader.setFloat("spotLight.cutOff", glm::cos(glm::radians(20.0f)));
-        ourShader.setFloat("spotLight.outerCutOff", glm::cos(glm::radians(25.0f)));
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 6000.0f);
+        glm::mat4 view = camera.GetViewMatrix();
 
-        ourShader.setMat4("projection", projection);
-        ourShader.setMat4("view", view);
+        setSceneLights(sceneShader, scene, projection, view);
 
         // PISO
         glm::mat4 model = glm::mat4(1.0f);
-        ourShader.setMat4("model", model);
+        sceneShader.setMat4("model", model);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, floorTexture);
-        ourShader.setInt("material.texture_diffuse1", 0);
+        sceneShader.setInt("material.texture_diffuse1", 0);
         glBindVertexArray(planeVAO);
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
@@ -261,8 +359,58 @@ int main()
         model = glm::translate(model, bikePos);
         model = glm::rotate(model, glm::radians(bikeAngle - 90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
         model = glm::scale(model, glm::vec3(1.0f));
-        ourShader.setMat4("model", model);
-        moto.Draw(ourShader);
+        sceneShader.setMat4("model", model);
+        sceneShader.setVec3("spotLight.diffuse", glm::vec3(scene.modelSpot[motoIndex].x));
+        sceneShader.setVec3("spotLight.specular", glm::vec3(scene.modelSpot[motoIndex].y));
+        models[motoIndex]->Draw(sceneShader);
+
+        // =================================================================================
+        // --- MAPA: AVENIDA CENTRAL (desde scenes/avenida.scene) ---
+        // =================================================================================
+
+        glm::vec4 frustumPlanes[6];
+        extractFrustumPlanes(projection * view, frustumPlanes);
+
+        // A) MODELOS
+        if (useGpuCulling)
+        {
+            // GPU: compute shader + un glMultiDrawElementsIndirect por material
+            gpuCulling.cull(projection * view, camera.Position);
+            setSceneLights(*sceneIndirectShader, scene, projection, view);
+            gpuCulling.draw(*sceneIndirectShader, scene, models);
+        }
+        else
+        {
+            // CPU: cada modelo recorre su rango contiguo de instancias visibles
+            sceneShader.use();
+            for (uint32_t m = 0; m < scene.modelNames.size(); m++)
+            {
+                if ((int)m == motoIndex || isSceneEsfera(scene, m) || scene.modelCount[m] == 0)
+                    continue;
+
+                // Respuesta de cada modelo al faro de la moto
+                sceneShader.setVec3("spotLight.diffuse", glm::vec3(scene.modelSpot[m].x));
+                sceneShader.setVec3("spotLight.specular", glm::vec3(scene.modelSpot[m].y));
+
+                uint32_t last = scene.modelFirst[m] + scene.modelCount[m];
+                for (uint32_t i = scene.modelFirst[m]; i < last; i++)
+                {
+                    if (!sphereVisible(frustumPlanes, statics.spheres[i], camera.Position))
+                        continue;
+                    sceneShader.setMat4("model", statics.matrices[i]);
+                    models[m]->Draw(sceneShader);
+                }
+            }
+        }
+
+        // Diferido: iluminar desde el G-buffer; los emisivos siguen en forward sobre su profundidad
+        if (deferredFrame)
+        {
+            setSceneLights(deferredLightShader, scene, projection, view);
+            setSceneLights(deferredPointShader, scene, projection, view);
+            deferred.lightingPass(deferredLightShader, deferredPointShader, scene, projection, view,
+                                  NR_POINT_LIGHTS, fogColor, renderSphere);
+        }
 
         // =========================================================
         // --- LUCES DE FRENO (CONFIGURACIÓN FINAL) ---
@@ -345,166 +493,27 @@ int main()
         lampShader.setMat4("model", model);
         renderSphere();
 
-        // =================================================================================
-        // --- MAPA: AVENIDA CENTRAL ---
-        // =================================================================================
-
-        // --- VARIABLES DE CALIBRACIÓN (TUS VALORES ORIGINALES) ---
-        float scalePoste = 350.0f;
-        float scaleArbol = 30.0f;
-
-        // 1. CENTRADO DEL POSTE (Variable existente - NO TOCADA)
-        float ajusteCentroX = -6.5f;
-
-        // 2. AJUSTE FINO DE BOMBILLAS (NO TOCADO)
-        float alturaFoco = 13.0f;
-        float distanciaBrazo = 3.0f;
-
-        // ---> ¡VARIABLE TUYA! CORRECCIÓN HORIZONTAL (NO TOCADA) <---
-        float correccionLucesX = 7.0f;
-
-        // 3. SEPARACIÓN DE ÁRBOLES
-        float treeDist = 35.0f;
-
-        float startZ = 100.0f;
-        float endZ = -2000.0f;
-        float posteSpacing = 40.0f;
-        float treeSpacing = 20.0f;
-
-        // A) BUCLE DE POSTES CENTRALES (TU LÓGICA INTACTA)
-        for (float z = startZ; z > endZ; z -= posteSpacing)
-        {
-            // --- POSTE ---
-            glm::vec3 postePos = glm::vec3(ajusteCentroX + 7.0f, -0.5f, z);
-
-            // --- DETECCIÓN DE COLISIÓN ---
-            // Radio moto, Radio poste
-            if (checkCollision(bikePos, 0.8f, postePos, 0.5f))
-            {
-                bikePos = oldBikePos; // Resetear posición
-                currentSpeed = 0;     // Detener moto
-            }
-
-            ourShader.use();
-            ourShader.setVec3("spotLight.diffuse", 0.5f, 0.5f, 0.5f);
-            ourShader.setVec3("spotLight.specular", 0.5f, 0.5f, 0.5f);
-
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(ajusteCentroX, -0.5f, z));
-            model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(scalePoste));
-            ourShader.setMat4("model", model);
-            poste.Draw(ourShader);
-
-            // --- BOMBILLAS (LUCES) ---
-            lampShader.use();
-            lampShader.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-            lampShader.setMat4("projection", projection);
-            lampShader.setMat4("view", view);
-
-            // Foco Izquierdo
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(ajusteCentroX - distanciaBrazo + correccionLucesX, alturaFoco, z));
-            model = glm::scale(model, glm::vec3(0.35f));
-            lampShader.setMat4("model", model);
-            renderSphere();
-
-            // Foco Derecho
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(ajusteCentroX + distanciaBrazo + correccionLucesX, alturaFoco, z));
-            model = glm::scale(model, glm::vec3(0.35f));
-            lampShader.setMat4("model", model);
-            renderSphere();
-        }
-
-        // B) BUCLE DE ÁRBOLES (TU LÓGICA INTACTA)
-        ourShader.use();
-        ourShader.setVec3("spotLight.diffuse", 0.8f, 0.8f, 0.8f);
-        for (float z = startZ; z > endZ; z -= treeSpacing)
-        {
-            // --- Árbol Derecho ---
-            glm::vec3 posArbolDer = glm::vec3(treeDist, -0.5f, z);
-            if (checkCollision(bikePos, 0.8f, posArbolDer, 0.5f)) // Radio de árbol un poco más ancho
-            {
-                bikePos = oldBikePos;
-                currentSpeed = 0.0f;
-            }
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(treeDist, -0.5f, z));
-            model = glm::scale(model, glm::vec3(scaleArbol));
-            ourShader.setMat4("model", model);
-            arbol.Draw(ourShader);
-
-            // --- Árbol Izquierdo ---
-                glm::vec3 posArbolIzq = glm::vec3(-treeDist, -0.5f, z);
-            if (checkCollision(bikePos, 0.8f, posArbolIzq, 0.5f))
-            {
-                bikePos = oldBikePos;
-                currentSpeed = 0.0f;
-            }
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(-treeDist, -0.5f, z));
-            model = glm::scale(model, glm::vec3(scaleArbol));
-            ourShader.setMat4("model", model);
-            arbol.Draw(ourShader);
-        }
-
-        // ---> C) BUCLE DE CASAS (MODIFICADO: MENOS CASAS) <---
-        float distCasas = 55.0f;
-        float scaleCasa = 0.02f;
-
-        // ¡AQUÍ ESTÁ EL TRUCO!
-        // Aumenta este número para separar más las casas.
-        // 20.0f = Muchas casas (pegadas). 100.0f = Pocas casas (dispersas).
-        float houseSpacing = 150.0f;
-
-        for (float z = startZ; z > endZ; z -= houseSpacing)
+        // B) BOMBILLAS (esferas emisivas)
+        lampShader.use();
+        lampShader.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+        lampShader.setMat4("projection", projection);
+        lampShader.setMat4("view", view);
+        for (uint32_t m = 0; m < scene.modelNames.size(); m++)
         {
-            // Casa Izquierda
-            glm::vec3 posCasaIzq = glm::vec3(-distCasas - 11.0f, -0.5f, z - 6.0f);
-            if (checkCollision(bikePos, 0.8f, posCasaIzq, 14.0f)) // Radio de árbol un poco más ancho
-            {
-                bikePos = oldBikePos;
-                currentSpeed = 0.0f;
-            }
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(-distCasas, -0.5f, z));
-            model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(scaleCasa));
-            ourShader.setMat4("model", model);
-            casaModel.Draw(ourShader);
-
-            // Casa Derecha
-            glm::vec3 posCasaDer = glm::vec3(distCasas + 11.0f, -0.5f, z - 6.0f);
-            if (checkCollision(bikePos, 0.8f, posCasaDer, 14.0f)) // Radio de árbol un poco más ancho
+            if (!isSceneEsfera(scene, m))
+                continue;
+            uint32_t last = scene.modelFirst[m] + scene.modelCount[m];
+            for (uint32_t i = scene.modelFirst[m]; i < last; i++)
             {
-                bikePos = oldBikePos;
-                currentSpeed = 0.0f;
+                if (!sphereVisible(frustumPlanes, statics.spheres[i], camera.Position))
+                    continue;
+                lampShader.setMat4("model", statics.matrices[i]);
+                renderSphere();
             }
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(distCasas, -0.5f, z));
-            model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(scaleCasa));
-            ourShader.setMat4("model", model);
-            casaModel.Draw(ourShader);
         }
 
-        // TEMPLE
-        float scaleTemple = 0.1f; // Ajusta el tamaño
-        glm::vec3 templePos = glm::vec3(0.0f, -0.5f, -2100.0f); // Guardamos la posición en una variable
-        if (checkCollision(bikePos, 0.8f, templePos, 26.0f))
-        {
-            bikePos = oldBikePos; // Resetear posición
-            currentSpeed = 0.0f;  // Detener la moto
-        }
-        ourShader.use();
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(0.0f, -0.5f, -2100.0f)); // Posición fija
-        model = glm::scale(model, glm::vec3(scaleTemple));
-        ourShader.setMat4("model", model);
-        temple.Draw(ourShader);
-
         // Restaurar luces fuertes
+        ourShader.use();
         ourShader.setVec3("spotLight.diffuse", 5.0f, 5.0f, 5.0f);
         ourShader.setVec3("spotLight.specular", 5.0f, 5.0f, 5.0f);
 
@@ -513,19 +522,34 @@ int main()
         lampShader.setMat4("projection", projection);
         lampShader.setMat4("view", view);
         model = glm::mat4(1.0f);
-        model = glm::translate(model, moonPos);
+        model = glm::translate(model, scene.moonPos);
         model = glm::scale(model, glm::vec3(15.0f));
         lampShader.setMat4("model", model);
         renderSphere();
 
-        int velocidadDisplay = abs((int)currentSpeed);
-        std::string title = "Night Ride | Velocidad: " + std::to_string(velocidadDisplay) + " km/h";
-        glfwSetWindowTitle(window, title.c_str());
+        framePacer.present();
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // El título solo se actualiza unas veces por segundo (es caro en el gestor de ventanas)
+        if (framePacer.hudDue())
+        {
+            const FrameStats &stats = framePacer.frameStats();
+            char limit[16] = "sin límite";
+            if (framePacer.targetFps() > 0.0)
+                snprintf(limit, sizeof(limit), "%.0f fps", framePacer.targetFps());
+            char title[224];
+            snprintf(title, sizeof(title), "Night Ride | Velocidad: %d km/h | %.1f ms (%.0f fps) | Tope %s | GPU %.1f ms | Latencia %.1f / %.1f ms | %s",
+                     abs((int)currentSpeed), stats.frameMs, stats.fps, limit, stats.gpuMs, stats.inputToSwapMs, stats.inputToGpuMs,
+                     useDeferred ? "Diferido" : "Forward");
+            glfwSetWindowTitle(window, title);
+        }
     }
 
+    // Liberar recursos de GPU mientras el contexto sigue vivo
+    assets.stop();
+    gpuCulling.release();
+    framePacer.release();
+    deferred.release();
+    models.clear();
     glDeleteVertexArrays(1, &planeVAO);
     glDeleteBuffers(1, &planeVBO);
     glfwTerminate();
@@ -559,6 +583,51 @@ unsigned int loadTexture(char const *path)
     return textureID;
 }
 
+// Uniforms de cámara y luces que comparten los shaders de la escena
+void setSceneLights(Shader &shader, const SceneData &scene, const glm::mat4 &projection, const glm::mat4 &view)
+{
+    shader.use();
+    shader.setVec3("viewPos", camera.Position);
+    shader.setFloat("material.shininess", 32.0f);
+    shader.setVec3("fogColor", fogColor);
+
+    // LUCES
+    shader.setVec3("dirLight.direction", -scene.moonPos);
+    shader.setVec3("dirLight.ambient", 0.3f, 0.3f, 0.4f);
+    shader.setVec3("dirLight.diffuse", 0.6f, 0.6f, 0.7f);
+    shader.setVec3("dirLight.specular", 0.5f, 0.5f, 0.5f);
+
+    for (int i = 0; i < NR_POINT_LIGHTS && i < (int)scene.pointLightPositions.size(); i++)
+    {
+        std::string number = std::to_string(i);
+        shader.setVec3("pointLights[" + number + "].position", scene.pointLightPositions[i]);
+        shader.setVec3("pointLights[" + number + "].ambient", 0.05f, 0.05f, 0.05f);
+        shader.setVec3("pointLights[" + number + "].diffuse", scene.pointLightColors[i]);
+        shader.setVec3("pointLights[" + number + "].specular", 1.0f, 1.0f, 1.0f);
+        shader.setFloat("pointLights[" + number + "].constant", 1.0f);
+        shader.setFloat("pointLights[" + number + "].linear", 0.022f);
+        shader.setFloat("pointLights[" + number + "].quadratic", 0.0019f);
+    }
+
+    glm::vec3 bikeFront;
+    bikeFront.x = -sin(glm::radians(bikeAngle));
+    bikeFront.y = 0.0f;
+    bikeFront.z = -cos(glm::radians(bikeAngle));
+    shader.setVec3("spotLight.position", bikePos + glm::vec3(0.0f, 1.0f, 0.0f));
+    shader.setVec3("spotLight.direction", glm::normalize(bikeFront));
+    shader.setVec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
+    shader.setVec3("spotLight.diffuse", 5.0f, 5.0f, 5.0f);
+    shader.setVec3("spotLight.specular", 5.0f, 5.0f, 5.0f);
+    shader.setFloat("spotLight.constant", 1.0f);
+    shader.setFloat("spotLight.linear", 0.022f);
+    shader.setFloat("spotLight.quadratic", 0.0019f);
+    shader.setFloat("spotLight.cutOff", glm::cos(glm::radians(20.0f)));
+    shader.setFloat("spotLight.outerCutOff", glm::cos(glm::radians(25.0f)));
+
+    shader.setMat4("projection", projection);
+    shader.setMat4("view", view);
+}
+
 void processInput(GLFWwindow *window)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -570,6 +639,58 @@ void processInput(GLFWwindow *window)
     bikePos.x += -sin(glm::radians(bikeAngle)) * currentSpeed * deltaTime;
     bikePos.z += -cos(glm::radians(bikeAngle)) * currentSpeed * deltaTime;
 
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS)
+    {
+        if (!gKeyPressed)
+        {
+            useGpuCulling = !useGpuCulling;
+            gKeyPressed = true;
+        }
+    }
+    else
+    {
+        gKeyPressed = false;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS)
+    {
+        if (!bKeyPressed)
+        {
+            useDeferred = !useDeferred;
+            bKeyPressed = true;
+        }
+    }
+    else
+    {
+        bKeyPressed = false;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
+    {
+        if (!fKeyPressed)
+        {
+            vsyncCycleRequested = true;
+            fKeyPressed = true;
+        }
+    }
+    else
+    {
+        fKeyPressed = false;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS)
+    {
+        if (!lKeyPressed)
+        {
+            fpsCycleRequested = true;
+            lKeyPressed = true;
+        }
+    }
+    else
+    {
+        lKeyPressed = false;
+    }
+
     if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS)
     {
         if (!vKeyPressed)
@@ -0,0 +1,610 @@
+#ifndef ASSET_RELOAD_H
+#define ASSET_RELOAD_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/model.h>
+#include <learnopengl/stb_image.h>
+
+#include "scene.h"
+#include "mesh_optimizer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// =================================================================================
+// RECARGA DE ASSETS EN CALIENTE
+// =================================================================================
+//
+//  - FileWatcher: inotify sobre las carpetas de los archivos vigilados (Linux) o
+//    revisión periódica de fechas con stat (resto). Un cambio se entrega cuando el
+//    archivo lleva RELOAD_SETTLE_TIME sin tocarse (los editores guardan en pasos).
+//  - Shaders: se recompilan en el hilo principal; el programa nuevo solo reemplaza
+//    al anterior si enlaza, si no se sigue con el que había.
+//  - Texturas (el suelo y las de los modelos): se decodifican en el hilo de carga
+//    y se suben en el principal. En las de modelo se cambia el id de la entrada de
+//    la TextureCache, así la ven todos los lotes que la usan sin tocar el modelo.
+//  - Modelos (solo por cambios en el .obj o en sus .mtl): Assimp + cookModel en el hilo
+//    de carga, con un contexto GL oculto compartido (las texturas del Model se crean
+//    ahí). El PackedModel se arma en el hilo principal (los VAO no se comparten
+//    entre contextos) y reutiliza las texturas que ya estén en la caché.
+//  - Con RELOAD_STATS definido se imprime lo que tardó cada recarga; los errores
+//    (ERROR RECARGA) se imprimen siempre.
+//  - Todo se cambia en update(), entre frames. models[i] es el único dueño de cada
+//    modelo: el anterior se borra al reemplazarlo. Las texturas sí se comparten y se
+//    borran con el último modelo que las usa. Los objetos GL borrados siguen vivos
+//    en el driver mientras los frames en vuelo los usen.
+
+const double RELOAD_SETTLE_TIME = 0.2;   // Segundos sin cambios antes de recargar
+const double RELOAD_POLL_INTERVAL = 0.5; // Solo sin inotify: cada cuánto se revisan fechas
+
+inline std::string assetDirectory(const std::string &path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+}
+
+inline std::string assetJoin(const std::string &directory, const std::string &name)
+{
+    return directory == "." ? name : directory + "/" + name;
+}
+
+class FileWatcher
+{
+public:
+    FileWatcher()
+    {
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            std::cout << "ERROR RECARGA: inotify no disponible, se revisan las fechas" << std::endl;
+#endif
+    }
+
+    ~FileWatcher()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    void watch(const std::string &path)
+    {
+        if (!files.insert(path).second)
+            return;
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            std::string directory = assetDirectory(path);
+            if (directoryWatches.count(directory))
+                return;
+            int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd >= 0)
+            {
+                directoryWatches[directory] = wd;
+                watchedDirectories[wd] = directory;
+                return;
+            }
+        }
+#endif
+        // Sin inotify (o sin permiso sobre la carpeta): revisar la fecha
+        time_t mtime = 0;
+        sceneFileTime(path, mtime);
+        polled[path] = mtime;
+    }
+
+    // Rutas vigiladas que cambiaron y ya llevan RELOAD_SETTLE_TIME quietas
+    void poll(double now, std::vector<std::string> &changed)
+    {
+        changed.clear();
+#ifdef __linux__
+        readEvents(now);
+#endif
+        scanTimes(now);
+
+        std::map<std::string, double>::iterator it = pending.begin();
+        while (it != pending.end())
+        {
+            if (now - it->second >= RELOAD_SETTLE_TIME)
+            {
+                changed.push_back(it->first);
+                it = pending.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+private:
+    std::set<std::string> files;
+    std::map<std::string, double> pending; // ruta -> último cambio visto
+    std::map<std::string, time_t> polled;
+    double lastScan = -1.0e9;
+
+#ifdef __linux__
+    int fd = -1;
+    std::map<std::string, int> directoryWatches;
+    std::map<int, std::string> watchedDirectories;
+
+    void readEvents(double now)
+    {
+        if (fd < 0)
+            return;
+        alignas(alignof(struct inotify_event)) char buffer[4096];
+        for (;;)
+        {
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if (length <= 0) // EAGAIN: no quedan eventos
+                break;
+            for (ssize_t i = 0; i < length;)
+            {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + i);
+                std::map<int, std::string>::const_iterator directory = watchedDirectories.find(event->wd);
+                if (event->len > 0 && directory != watchedDirectories.end())
+                {
+                    std::string path = assetJoin(directory->second, event->name);
+                    if (files.count(path))
+                        pending[path] = now;
+                }
+                i += sizeof(struct inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+
+    void scanTimes(double now)
+    {
+        if (polled.empty() || now - lastScan < RELOAD_POLL_INTERVAL)
+            return;
+        lastScan = now;
+        for (std::map<std::string, time_t>::iterator it = polled.begin(); it != polled.end(); ++it)
+        {
+            time_t mtime = 0;
+            if (sceneFileTime(it->first, mtime) && mtime != it->second)
+            {
+                it->second = mtime;
+                pending[it->first] = now;
+            }
+        }
+    }
+};
+
+// Archivos cuya edición obliga a reimportar un modelo: el propio archivo y sus
+// bibliotecas de materiales (las líneas mtllib del .obj, relativas a su carpeta; si
+// no hay ninguna, <nombre>.mtl). Las texturas se recargan solas por la TextureCache.
+inline std::vector<std::string> modelSourceFiles(const std::string &path)
+{
+    std::vector<std::string> files(1, path);
+    std::string directory = assetDirectory(path);
+    time_t mtime;
+
+    std::ifstream obj(path);
+    std::string line;
+    bool hasMtllib = false;
+    while (std::getline(obj, line))
+    {
+        if (line.compare(0, 7, "mtllib ") != 0 && line.compare(0, 7, "mtllib\t") != 0)
+            continue;
+        hasMtllib = true;
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+
+        // Puede listar varios archivos; si ninguno existe, probar la línea entera
+        // (nombres con espacios)
+        std::istringstream names(line.substr(7));
+        std::string name;
+        bool found = false;
+        while (names >> name)
+        {
+            std::string file = assetJoin(directory, name);
+            if (sceneFileTime(file, mtime))
+            {
+                files.push_back(file);
+                found = true;
+            }
+        }
+        size_t first = line.find_first_not_of(" \t", 7);
+        if (!found && first != std::string::npos)
+        {
+            std::string file = assetJoin(directory, line.substr(first, line.find_last_not_of(" \t") + 1 - first));
+            if (sceneFileTime(file, mtime))
+                files.push_back(file);
+            else
+                std::cout << "ERROR RECARGA: " << path << " pide " << line.substr(first) << ", que no existe" << std::endl;
+        }
+    }
+
+    size_t dot = path.find_last_of('.');
+    if (!hasMtllib && dot != std::string::npos && sceneFileTime(path.substr(0, dot) + ".mtl", mtime))
+        files.push_back(path.substr(0, dot) + ".mtl");
+    return files;
+}
+
+class AssetReloader
+{
+public:
+    // Crear después de la ventana y antes de cargar los modelos
+    AssetReloader(GLFWwindow *mainWindow, const SceneData &scene, std::vector<std::shared_ptr<PackedModel>> &models,
+                  TextureCache &modelTextures)
+        : scene(scene), models(models), modelTextures(modelTextures), modelFiles(models.size())
+    {
+        // Contexto oculto que comparte texturas y buffers con la ventana (mismas hints de versión)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        loaderWindow = glfwCreateWindow(1, 1, "Night Ride - carga", NULL, mainWindow);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (loaderWindow)
+            worker = std::thread(&AssetReloader::workerLoop, this);
+        else
+            std::cout << "RECARGA: sin contexto compartido, los modelos se recargan en el hilo principal" << std::endl;
+    }
+
+    ~AssetReloader() { stop(); }
+
+    AssetReloader(const AssetReloader &) = delete;
+    AssetReloader &operator=(const AssetReloader &) = delete;
+
+    void watchShader(Shader &shader, const std::string &vertexPath, const std::string &fragmentPath)
+    {
+        ShaderEntry entry = {&shader, vertexPath, fragmentPath};
+        shaders.push_back(entry);
+        watcher.watch(vertexPath);
+        watcher.watch(fragmentPath);
+    }
+
+    // Texturas sueltas (fuera de la caché): texture apunta al id que usa el render y
+    // se reemplaza al recargar
+    void watchTexture(unsigned int &texture, const std::string &path)
+    {
+        TextureEntry entry = {&texture, path};
+        textures.push_back(entry);
+        watcher.watch(path);
+    }
+
+    // Llamar con el Model original, antes de releaseModelBuffers
+    void watchModel(uint32_t index, const Model &source)
+    {
+        modelFiles[index] = modelSourceFiles(scene.modelPaths[index]);
+        for (size_t f = 0; f < modelFiles[index].size(); f++)
+            watcher.watch(modelFiles[index][f]);
+        for (size_t t = 0; t < source.textures_loaded.size(); t++)
+            watcher.watch(source.directory + "/" + source.textures_loaded[t].path);
+    }
+
+    // Entre frames: lanza las recargas pendientes y aplica las terminadas.
+    // Devuelve true si cambió algún modelo (hay que rehacer instancias y culling).
+    bool update(double now)
+    {
+        watcher.poll(now, changed);
+        for (size_t c = 0; c < changed.size(); c++)
+        {
+            const std::string &path = changed[c];
+            for (size_t s = 0; s < shaders.size(); s++)
+            {
+                if (shaders[s].vertexPath == path || shaders[s].fragmentPath == path)
+                    reloadShader(shaders[s]);
+            }
+            bool looseTexture = false;
+            for (size_t t = 0; t < textures.size(); t++)
+                looseTexture |= textures[t].path == path;
+            if (looseTexture)
+                queueJob(RELOAD_TEXTURE, 0, path, false); // Igual que loadTexture
+            else if (modelTextures.find(path))
+                queueJob(RELOAD_TEXTURE, 0, path, true); // Igual que la carga de los modelos
+            for (size_t m = 0; m < modelFiles.size(); m++)
+            {
+                for (size_t f = 0; f < modelFiles[m].size(); f++)
+                {
+                    if (modelFiles[m][f] == path)
+                    {
+                        queueJob(RELOAD_MODEL, static_cast<uint32_t>(m), scene.modelPaths[m], true);
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::deque<ReloadResult> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.swap(results);
+        }
+        bool modelsChanged = false;
+        for (size_t r = 0; r < finished.size(); r++)
+            modelsChanged |= apply(finished[r]);
+        return modelsChanged;
+    }
+
+    // Antes de glfwTerminate. Si hay una carga en curso se espera a que termine.
+    void stop()
+    {
+        if (worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                quit = true;
+            }
+            jobReady.notify_one();
+            worker.join();
+        }
+        if (loaderWindow)
+            glfwDestroyWindow(loaderWindow);
+        loaderWindow = NULL;
+        for (size_t r = 0; r < results.size(); r++)
+            discardModel(results[r].model);
+        results.clear();
+        jobs.clear();
+    }
+
+private:
+    enum ReloadKind
+    {
+        RELOAD_TEXTURE,
+        RELOAD_MODEL
+    };
+
+    struct ShaderEntry
+    {
+        Shader *shader;
+        std::string vertexPath;
+        std::string fragmentPath;
+    };
+
+    struct TextureEntry
+    {
+        unsigned int *texture;
+        std::string path;
+    };
+
+    struct ReloadJob
+    {
+        ReloadKind kind;
+        uint32_t index; // Solo modelos
+        std::string path;
+        bool flip;      // stbi_set_flip_vertically_on_load
+    };
+
+    struct ReloadResult
+    {
+        ReloadJob job;
+        bool ok = false;
+        double seconds = 0.0; // Solo con RELOAD_STATS
+        // Textura decodificada
+        std::vector<unsigned char> pixels;
+        int width = 0, height = 0, components = 0;
+        // Modelo cocinado (sus texturas ya existen en el contexto compartido)
+        PackedModelData model;
+        std::vector<std::string> files;
+    };
+
+    const SceneData &scene;
+    std::vector<std::shared_ptr<PackedModel>> &models;
+    TextureCache &modelTextures;
+    std::vector<std::vector<std::string>> modelFiles;
+    std::vector<ShaderEntry> shaders;
+    std::vector<TextureEntry> textures;
+
+    FileWatcher watcher;
+    std::vector<std::string> changed;
+
+    GLFWwindow *loaderWindow = NULL;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::deque<ReloadJob> jobs;
+    std::deque<ReloadResult> results;
+    bool quit = false;
+
+    void reloadShader(ShaderEntry &entry)
+    {
+#ifdef RELOAD_STATS
+        double start = glfwGetTime();
+#endif
+        Shader fresh(entry.vertexPath.c_str(), entry.fragmentPath.c_str());
+        GLint linked = 0;
+        glGetProgramiv(fresh.ID, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            glDeleteProgram(fresh.ID);
+            std::cout << "ERROR RECARGA: " << entry.vertexPath << " + " << entry.fragmentPath
+                      << " no enlaza, se mantiene el anterior" << std::endl;
+            return;
+        }
+        // Los uniforms se vuelven a poner cada frame, basta con cambiar el programa
+        glDeleteProgram(entry.shader->ID);
+        entry.shader->ID = fresh.ID;
+#ifdef RELOAD_STATS
+        std::cout << "RECARGA shader " << entry.vertexPath << " + " << entry.fragmentPath << ": "
+                  << (glfwGetTime() - start) * 1000.0 << " ms" << std::endl;
+#endif
+    }
+
+    void queueJob(ReloadKind kind, uint32_t index, const std::string &path, bool flip)
+    {
+        ReloadJob job = {kind, index, path, flip};
+        if (!loaderWindow)
+        {
+            // Sin hilo de carga: en el principal (bloquea, pero sigue sin reiniciar)
+            results.push_back(runJob(job));
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t j = 0; j < jobs.size(); j++)
+            {
+                if (jobs[j].kind == kind && jobs[j].index == index && jobs[j].path == path)
+                    return; // Ya está en cola
+            }
+            jobs.push_back(job);
+        }
+        jobReady.notify_one();
+    }
+
+    void workerLoop()
+    {
+        // glad ya cargó los punteros con el contexto principal; el compartido usa los mismos
+        glfwMakeContextCurrent(loaderWindow);
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            jobReady.wait(lock, [this] { return quit || !jobs.empty(); });
+            if (quit)
+                break;
+            ReloadJob job = jobs.front();
+            jobs.pop_front();
+            lock.unlock();
+            ReloadResult result = runJob(job);
+            lock.lock();
+            results.push_back(std::move(result));
+        }
+        lock.unlock();
+        glfwMakeContextCurrent(NULL);
+    }
+
+    // Trabajo lento: corre en el hilo de carga. Un solo hilo, así el flag global
+    // de stb_image no se pisa entre trabajos.
+    static ReloadResult runJob(const ReloadJob &job)
+    {
+        ReloadResult result;
+        result.job = job;
+#ifdef RELOAD_STATS
+        double start = glfwGetTime();
+#endif
+        stbi_set_flip_vertically_on_load(job.flip);
+        if (job.kind == RELOAD_TEXTURE)
+        {
+            unsigned char *data = stbi_load(job.path.c_str(), &result.width, &result.height, &result.components, 0);
+            if (data)
+            {
+                result.pixels.assign(data, data + result.width * result.height * result.components);
+                result.ok = true;
+            }
+            stbi_image_free(data);
+        }
+        else
+        {
+            Model source(job.path);
+            if (!source.meshes.empty())
+            {
+                result.model = cookModel(source, "");
+                result.files = modelSourceFiles(job.path);
+                releaseModelBuffers(source);
+                result.ok = !result.model.batches.empty();
+            }
+            // Texturas completas antes de que el contexto principal las use
+            glFinish();
+        }
+        stbi_set_flip_vertically_on_load(false);
+#ifdef RELOAD_STATS
+        result.seconds = glfwGetTime() - start;
+#endif
+        return result;
+    }
+
+    // Hilo principal: subir / armar y cambiar el handle
+    bool apply(ReloadResult &result)
+    {
+        const ReloadJob &job = result.job;
+        if (!result.ok)
+        {
+            discardModel(result.model);
+            std::cout << "ERROR RECARGA: " << job.path << " no se pudo cargar, se mantiene el anterior" << std::endl;
+            return false;
+        }
+
+#ifdef RELOAD_STATS
+        double start = glfwGetTime();
+#endif
+        if (job.kind == RELOAD_TEXTURE)
+        {
+            // Una subida para todos los que usen esa ruta
+            unsigned int fresh = uploadTexture(result);
+            bool used = false;
+            for (size_t t = 0; t < textures.size(); t++)
+            {
+                if (textures[t].path == job.path)
+                {
+                    glDeleteTextures(1, textures[t].texture);
+                    *textures[t].texture = fresh;
+                    used = true;
+                }
+            }
+            std::shared_ptr<SharedTexture> cached = modelTextures.find(job.path);
+            if (cached && !used)
+            {
+                glDeleteTextures(1, &cached->id);
+                cached->id = fresh;
+                used = true;
+            }
+            if (!used) // Ningún modelo la usa ya
+                glDeleteTextures(1, &fresh);
+#ifdef RELOAD_STATS
+            std::cout << "RECARGA textura " << job.path << ": " << result.seconds * 1000.0 << " ms en segundo plano + "
+                      << (glfwGetTime() - start) * 1000.0 << " ms de subida" << std::endl;
+#endif
+            return false;
+        }
+
+        result.model.name = scene.modelNames[job.index];
+        // Se arma antes de soltar el anterior: las texturas que no cambiaron siguen en la caché
+        models[job.index].reset(new PackedModel(result.model, modelTextures));
+
+        // El modelo pudo ganar o perder texturas
+        modelFiles[job.index] = result.files;
+        for (size_t f = 0; f < result.files.size(); f++)
+            watcher.watch(result.files[f]);
+        for (size_t t = 0; t < result.model.loadedTextures.size(); t++)
+            watcher.watch(result.model.loadedTextures[t].path);
+
+#ifdef RELOAD_STATS
+        std::cout << "RECARGA modelo " << models[job.index]->name << ": " << result.seconds * 1000.0 << " ms en segundo plano + "
+                  << (glfwGetTime() - start) * 1000.0 << " ms de subida" << std::endl;
+#endif
+        return true;
+    }
+
+    // Mismos parámetros que loadTexture
+    static unsigned int uploadTexture(const ReloadResult &result)
+    {
+        unsigned int texture;
+        GLenum format = (result.components == 1) ? GL_RED : (result.components == 3 ? GL_RGB : GL_RGBA);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, result.width, result.height, 0, format, GL_UNSIGNED_BYTE, result.pixels.data());
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        return texture;
+    }
+
+    static void discardModel(PackedModelData &data)
+    {
+        for (size_t t = 0; t < data.loadedTextures.size(); t++)
+            glDeleteTextures(1, &data.loadedTextures[t].id);
+        data.loadedTextures.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+
+#include "scene.h"
+#include "mesh_optimizer.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =================================================================================
+// CULLING DE LAS INSTANCIAS ESTÁTICAS
+// =================================================================================
+//
+// Camino CPU (GL 3.3): prueba de esfera contra el frustum y la distancia de dibujo,
+// un draw por meshlet visible.
+// Camino GPU (GL 4.3+): instancias y esferas en SSBOs, un compute shader hace la misma
+// prueba y escribe DrawElementsIndirectCommand; cada material se dibuja con un solo
+// glMultiDrawElementsIndirect para todas sus instancias visibles.
+//
+// El proyecto compila contra un glad de GL 3.3, así que las cuatro funciones 4.2/4.3
+// que usa el camino GPU se cargan aquí con glfwGetProcAddress, solo si el contexto
+// que se obtuvo es 4.3 o mayor.
+
+// Más allá del final de la niebla todo se ve del color del fondo
+const float DRAW_DISTANCE = 4000.0f;
+
+// Matrices y esferas envolventes en mundo (SoA, mismo orden que SceneData)
+struct StaticInstances
+{
+    std::vector<glm::mat4> matrices;
+    std::vector<glm::vec4> spheres; // xyz = centro, w = radio
+};
+
+inline void buildStaticInstances(const SceneData &scene, const std::vector<std::shared_ptr<PackedModel>> &models, StaticInstances &out)
+{
+    size_t count = scene.instModel.size();
+    out.matrices.resize(count);
+    out.spheres.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, scene.instPositions[i]);
+        model = glm::rotate(model, glm::radians(scene.instRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(scene.instScales[i]));
+        out.matrices[i] = model;
+
+        // La esfera emisiva es de radio 1 centrada en el origen
+        const PackedModel *packed = models[scene.instModel[i]].get();
+        glm::vec3 center = packed ? packed->boundsCenter : glm::vec3(0.0f);
+        float radius = packed ? packed->boundsRadius : 1.0f;
+        out.spheres[i] = glm::vec4(glm::vec3(model * glm::vec4(center, 1.0f)), radius * scene.instScales[i]);
+    }
+}
+
+// Planos del frustum (Gribb-Hartmann), normalizados, apuntando hacia dentro
+inline void extractFrustumPlanes(const glm::mat4 &viewProjection, glm::vec4 planes[6])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        glm::vec4 row(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        planes[i * 2] = row3 + row;
+        planes[i * 2 + 1] = row3 - row;
+    }
+    for (int p = 0; p < 6; p++)
+        planes[p] /= glm::length(glm::vec3(planes[p].x, planes[p].y, planes[p].z));
+}
+
+inline bool sphereVisible(const glm::vec4 planes[6], const glm::vec4 &sphere, const glm::vec3 &viewPos)
+{
+    glm::vec3 center(sphere.x, sphere.y, sphere.z);
+    for (int p = 0; p < 6; p++)
+        if (glm::dot(glm::vec3(planes[p].x, planes[p].y, planes[p].z), center) + planes[p].w < -sphere.w)
+            return false;
+    return glm::distance(viewPos, center) - sphere.w <= DRAW_DISTANCE;
+}
+
+// --- GL 4.3 SIN DEPENDER DE GLAD ---
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+// Nombres propios: con un glad 4.3 los gl* originales ya son macros
+typedef void(APIENTRYP CullDispatchComputeProc)(GLuint, GLuint, GLuint);
+typedef void(APIENTRYP CullMemoryBarrierProc)(GLbitfield);
+typedef void(APIENTRYP CullMultiDrawElementsIndirectProc)(GLenum, GLenum, const void *, GLsizei, GLsizei);
+typedef void(APIENTRYP CullClearBufferDataProc)(GLenum, GLenum, GLenum, GLenum, const void *);
+
+struct GpuCullingApi
+{
+    CullDispatchComputeProc dispatchCompute;
+    CullMemoryBarrierProc memoryBarrier;
+    CullMultiDrawElementsIndirectProc multiDrawElementsIndirect;
+    CullClearBufferDataProc clearBufferData;
+};
+
+inline GpuCullingApi &gpuCullingApi()
+{
+    static GpuCullingApi api = {NULL, NULL, NULL, NULL};
+    return api;
+}
+
+inline bool loadGpuCullingApi()
+{
+    // El contexto se pidió como 4.3 pero puede haber caído a 3.3
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major < 4 || (major == 4 && minor < 3))
+        return false;
+
+    GpuCullingApi &api = gpuCullingApi();
+    api.dispatchCompute = (CullDispatchComputeProc)glfwGetProcAddress("glDispatchCompute");
+    api.memoryBarrier = (CullMemoryBarrierProc)glfwGetProcAddress("glMemoryBarrier");
+    api.multiDrawElementsIndirect = (CullMultiDrawElementsIndirectProc)glfwGetProcAddress("glMultiDrawElementsIndirect");
+    api.clearBufferData = (CullClearBufferDataProc)glfwGetProcAddress("glClearBufferData");
+    return api.dispatchCompute && api.memoryBarrier && api.multiDrawElementsIndirect && api.clearBufferData;
+}
+
+// Con el contexto actual; se resuelve una sola vez
+inline bool gpuCullingSupported()
+{
+    static bool supported = loadGpuCullingApi();
+    return supported;
+}
+
+// Compute shader; learnopengl/shader.h solo compila vertex + fragment
+inline unsigned int loadComputeProgram(const char *path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::SHADER::COMPUTE::FILE_NOT_READ " << path << std::endl;
+        return 0;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    std::string code = stream.str();
+    const char *source = code.c_str();
+
+    GLint success;
+    char infoLog[1024];
+    unsigned int shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: COMPUTE " << path << "\n" << infoLog << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glDeleteShader(shader);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glGetProgramInfoLog(program, 1024, NULL, infoLog);
+        std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: COMPUTE " << path << "\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Mismo layout std430 que 'Instance' en cull.cs
+struct GpuInstance
+{
+    glm::mat4 model;
+    glm::vec4 sphere;
+    uint32_t info[4]; // x = modelo, y = primera instancia del modelo
+};
+static_assert(sizeof(GpuInstance) == 96, "GpuInstance debe coincidir con std430");
+
+struct DrawElementsIndirectCommand
+{
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+class GpuCulling
+{
+public:
+    GpuCulling() {}
+    ~GpuCulling() { release(); }
+
+    GpuCulling(const GpuCulling &) = delete;
+    GpuCulling &operator=(const GpuCulling &) = delete;
+
+    bool ready() const { return cullProgram != 0 && commandProgram != 0; }
+
+    // Una vez al inicio: compila los compute shaders y sube los buffers
+    bool build(const SceneData &scene, const StaticInstances &statics, const std::vector<std::shared_ptr<PackedModel>> &models)
+    {
+        if (!gpuCullingSupported())
+            return false;
+        release();
+        cullProgram = loadComputeProgram("shaders/cull.cs");
+        commandProgram = loadComputeProgram("shaders/cull_commands.cs");
+        if (!ready())
+        {
+            release();
+            return false;
+        }
+        rebuildBuffers(scene, statics, models);
+        return true;
+    }
+
+    // Vuelve a subir instancias y comandos (p. ej. al recargar un modelo) sin tocar
+    // los programas; reutiliza los mismos buffers
+    void rebuildBuffers(const SceneData &scene, const StaticInstances &statics, const std::vector<std::shared_ptr<PackedModel>> &models)
+    {
+        if (!ready())
+            return;
+
+        instanceCount = static_cast<uint32_t>(scene.instModel.size());
+        std::vector<GpuInstance> instances(instanceCount);
+        for (uint32_t i = 0; i < instanceCount; i++)
+        {
+            instances[i].model = statics.matrices[i];
+            instances[i].sphere = statics.spheres[i];
+            instances[i].info[0] = scene.instModel[i];
+            instances[i].info[1] = scene.modelFirst[scene.instModel[i]];
+            instances[i].info[2] = 0;
+            instances[i].info[3] = 0;
+        }
+
+        // Un comando por meshlet; baseInstance apunta a la región del modelo en 'visible'
+        std::vector<DrawElementsIndirectCommand> commands;
+        std::vector<uint32_t> commandModel;
+        batchRanges.clear();
+        for (uint32_t m = 0; m < models.size(); m++)
+        {
+            if (!models[m] || scene.modelCount[m] == 0)
+                continue;
+            for (size_t b = 0; b < models[m]->batches.size(); b++)
+            {
+                const PackedBatch &batch = models[m]->batches[b];
+                BatchRange range = {m, static_cast<uint32_t>(b), static_cast<uint32_t>(commands.size()), static_cast<uint32_t>(batch.draws.size())};
+                batchRanges.push_back(range);
+                for (size_t d = 0; d < batch.draws.size(); d++)
+                {
+                    DrawElementsIndirectCommand cmd = {batch.draws[d].indexCount, 0, batch.draws[d].firstIndex, batch.draws[d].baseVertex, scene.modelFirst[m]};
+                    commands.push_back(cmd);
+                    commandModel.push_back(m);
+                }
+            }
+        }
+        commandCount = static_cast<uint32_t>(commands.size());
+        modelTotal = static_cast<uint32_t>(models.size());
+
+        if (!instanceBuffer)
+        {
+            glGenBuffers(1, &instanceBuffer);
+            glGenBuffers(1, &visibleBuffer);
+            glGenBuffers(1, &countBuffer);
+            glGenBuffers(1, &commandBuffer);
+            glGenBuffers(1, &commandModelBuffer);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(GpuInstance), instances.data(), GL_STATIC_DRAW);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, instanceCount * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, modelTotal * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_DYNAMIC_DRAW);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandModelBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, commandModel.size() * sizeof(uint32_t), commandModel.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        // Atributo por instancia (location 3): índice de la instancia visible
+        for (size_t m = 0; m < models.size(); m++)
+        {
+            if (!models[m])
+                continue;
+            glBindVertexArray(models[m]->VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+            glEnableVertexAttribArray(3);
+            glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, 0, (void *)0);
+            glVertexAttribDivisor(3, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Culling en GPU: limpia contadores, prueba instancias, completa los comandos
+    void cull(const glm::mat4 &viewProjection, const glm::vec3 &viewPos)
+    {
+        glm::vec4 planes[6];
+        extractFrustumPlanes(viewProjection, planes);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        gpuCullingApi().clearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibleBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, countBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, commandModelBuffer);
+
+        glUseProgram(cullProgram);
+        glUniform4fv(glGetUniformLocation(cullProgram, "frustumPlanes"), 6, glm::value_ptr(planes[0]));
+        glUniform3fv(glGetUniformLocation(cullProgram, "viewPos"), 1, glm::value_ptr(viewPos));
+        glUniform1f(glGetUniformLocation(cullProgram, "drawDistance"), DRAW_DISTANCE);
+        glUniform1ui(glGetUniformLocation(cullProgram, "instanceCount"), instanceCount);
+        gpuCullingApi().dispatchCompute((instanceCount + 63) / 64, 1, 1);
+        gpuCullingApi().memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUseProgram(commandProgram);
+        glUniform1ui(glGetUniformLocation(commandProgram, "commandCount"), commandCount);
+        gpuCullingApi().dispatchCompute((commandCount + 63) / 64, 1, 1);
+        gpuCullingApi().memoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+
+    // Un glMultiDrawElementsIndirect por material de cada modelo
+    void draw(Shader &shader, const SceneData &scene, const std::vector<std::shared_ptr<PackedModel>> &models)
+    {
+        shader.use();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+        uint32_t currentModel = modelTotal;
+        for (size_t r = 0; r < batchRanges.size(); r++)
+        {
+            const BatchRange &range = batchRanges[r];
+            PackedModel &packed = *models[range.model];
+            if (range.model != currentModel)
+            {
+                currentModel = range.model;
+                shader.setVec3("spotLight.diffuse", glm::vec3(scene.modelSpot[currentModel].x));
+                shader.setVec3("spotLight.specular", glm::vec3(scene.modelSpot[currentModel].y));
+                glBindVertexArray(packed.VAO);
+            }
+            packed.bindTextures(shader, packed.batches[range.batch]);
+            gpuCullingApi().multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT,
+                                        (void *)(range.firstCommand * sizeof(DrawElementsIndirectCommand)), range.commandCount, 0);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void release()
+    {
+        if (cullProgram)
+            glDeleteProgram(cullProgram);
+        if (commandProgram)
+            glDeleteProgram(commandProgram);
+        if (instanceBuffer)
+        {
+            unsigned int buffers[5] = {instanceBuffer, visibleBuffer, countBuffer, commandBuffer, commandModelBuffer};
+            glDeleteBuffers(5, buffers);
+        }
+        cullProgram = commandProgram = 0;
+        instanceBuffer = visibleBuffer = countBuffer = commandBuffer = commandModelBuffer = 0;
+    }
+
+private:
+    struct BatchRange
+    {
+        uint32_t model;
+        uint32_t batch;
+        uint32_t firstCommand;
+        uint32_t commandCount;
+    };
+
+    unsigned int cullProgram = 0, commandProgram = 0;
+    unsigned int instanceBuffer = 0, visibleBuffer = 0, countBuffer = 0, commandBuffer = 0, commandModelBuffer = 0;
+    uint32_t instanceCount = 0, commandCount = 0, modelTotal = 0;
+    std::vector<BatchRange> batchRanges;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/shader.h>
+
+#include "scene.h"
+
+#include <cmath>
+#include <iostream>
+
+// =================================================================================
+// CAMINO DIFERIDO (G-BUFFER)
+// =================================================================================
+//
+// 1. Geometría: gbuffer.fs guarda por píxel
+//      RT0 RGBA8   : albedo (rgb) + intensidad especular (a)
+//      RT1 RGBA16F : normal octaédrica (rg) + respuesta al faro difusa/especular (ba)
+//      Depth       : DEPTH24_STENCIL8 (la posición se reconstruye desde la profundidad)
+// 2. Luz direccional + faro + niebla en una pasada de pantalla completa.
+// 3. Luces puntuales como volúmenes: con la profundidad del G-buffer ya copiada al
+//    framebuffer por defecto, una pasada de stencil a dos caras marca solo los
+//    píxeles cuya geometría queda dentro de la esfera, y la luz se suma solo ahí.
+// 4. Esa misma profundidad la usan después los emisivos en directo.
+//
+// Cada píxel lee el G-buffer una vez por pasada, en lugar de 3 texturas por luz.
+
+// Mismos valores que setSceneLights
+const float POINT_LIGHT_CONSTANT = 1.0f;
+const float POINT_LIGHT_LINEAR = 0.022f;
+const float POINT_LIGHT_QUADRATIC = 0.0019f;
+
+// Distancia a la que la luz ya aporta menos de 5/256 (más un margen por la teselación)
+inline float pointLightRadius(glm::vec3 color)
+{
+    float maxChannel = std::fmax(std::fmax(color.x, color.y), color.z);
+    float c = POINT_LIGHT_CONSTANT - (256.0f / 5.0f) * maxChannel;
+    float disc = POINT_LIGHT_LINEAR * POINT_LIGHT_LINEAR - 4.0f * POINT_LIGHT_QUADRATIC * c;
+    return 1.05f * (-POINT_LIGHT_LINEAR + std::sqrt(disc)) / (2.0f * POINT_LIGHT_QUADRATIC);
+}
+
+class DeferredRenderer
+{
+public:
+    DeferredRenderer() {}
+    ~DeferredRenderer() { release(); }
+
+    DeferredRenderer(const DeferredRenderer &) = delete;
+    DeferredRenderer &operator=(const DeferredRenderer &) = delete;
+
+    // Enlaza el G-buffer (recreándolo si cambió el tamaño de la ventana)
+    bool beginGeometryPass(int fbWidth, int fbHeight)
+    {
+        if (fbWidth != width || fbHeight != height)
+        {
+            if (!create(fbWidth, fbHeight))
+                return false;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return true;
+    }
+
+    // Ilumina el framebuffer por defecto desde el G-buffer. Los shaders ya deben
+    // tener los uniforms de setSceneLights; drawSphere dibuja una esfera unitaria.
+    void lightingPass(Shader &lightShader, Shader &pointShader, const SceneData &scene,
+                      const glm::mat4 &projection, const glm::mat4 &view, int pointLightCount,
+                      const glm::vec3 &background, void (*drawSphere)())
+    {
+        glm::mat4 invViewProjection = glm::inverse(projection * view);
+
+        // Profundidad del G-buffer al framebuffer por defecto: la usan los volúmenes
+        // de luz y luego los emisivos
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        // Donde no hay geometría queda el fondo (la niebla)
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glClearColor(background.x, background.y, background.z, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, albedoSpec);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, normalSpot);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, depth);
+
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+
+        // A. Luna + faro + niebla (triángulo de pantalla completa)
+        lightShader.use();
+        setGBufferUniforms(lightShader, invViewProjection);
+        glBindVertexArray(emptyVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        // B. Luces puntuales: solo la geometría dentro de cada volumen
+        pointShader.use();
+        setGBufferUniforms(pointShader, invViewProjection);
+        pointShader.setMat4("projection", projection);
+        pointShader.setMat4("view", view);
+        glEnable(GL_STENCIL_TEST);
+        for (int i = 0; i < pointLightCount && i < (int)scene.pointLightPositions.size(); i++)
+        {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, scene.pointLightPositions[i]);
+            model = glm::scale(model, glm::vec3(pointLightRadius(scene.pointLightColors[i])));
+            pointShader.setMat4("model", model);
+            pointShader.setInt("lightIndex", i);
+
+            // B1. Stencil: la cara trasera detrás de la geometría suma y la delantera
+            // detrás de la geometría resta; queda != 0 si la geometría está dentro
+            // (también con la cámara dentro, donde la cara delantera no se dibuja).
+            // Con el orden invertido solo cambia el signo, y != 0 sigue valiendo.
+            glClear(GL_STENCIL_BUFFER_BIT);
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_LESS);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glStencilFunc(GL_ALWAYS, 0, 0xFF);
+            glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+            glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+            drawSphere();
+
+            // B2. Luz: ambas caras, sin culling (no depende del orden de los vértices de
+            // la esfera; con la cámara dentro solo se ven las traseras). El primer
+            // fragmento que pasa pone el stencil a 0, así cada píxel se suma una vez.
+            glDisable(GL_DEPTH_TEST);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+            glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE);
+            drawSphere();
+            glDisable(GL_BLEND);
+        }
+        glDisable(GL_STENCIL_TEST);
+
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void release()
+    {
+        if (fbo)
+        {
+            unsigned int textures[3] = {albedoSpec, normalSpot, depth};
+            glDeleteTextures(3, textures);
+            glDeleteFramebuffers(1, &fbo);
+        }
+        if (emptyVAO)
+            glDeleteVertexArrays(1, &emptyVAO);
+        fbo = albedoSpec = normalSpot = depth = emptyVAO = 0;
+        width = height = 0;
+    }
+
+private:
+    unsigned int fbo = 0, albedoSpec = 0, normalSpot = 0, depth = 0, emptyVAO = 0;
+    int width = 0, height = 0;
+
+    static unsigned int createTarget(GLint internalFormat, GLenum format, GLenum type, int w, int h)
+    {
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+
+    bool create(int w, int h)
+    {
+        release();
+        if (w <= 0 || h <= 0) // ventana minimizada
+            return false;
+        width = w;
+        height = h;
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        albedoSpec = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, w, h);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoSpec, 0);
+        normalSpot = createTarget(GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, w, h);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalSpot, 0);
+        // Mismo formato que el framebuffer por defecto para poder copiar la profundidad
+        depth = createTarget(GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, w, h);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+
+        unsigned int attachments[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, attachments);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!complete)
+        {
+            std::cout << "ERROR G-BUFFER: framebuffer incompleto" << std::endl;
+            release();
+            return false;
+        }
+
+        // El core profile exige un VAO aunque el triángulo salga de gl_VertexID
+        glGenVertexArrays(1, &emptyVAO);
+        return true;
+    }
+
+    void setGBufferUniforms(Shader &shader, const glm::mat4 &invViewProjection)
+    {
+        shader.setInt("gAlbedoSpec", 0);
+        shader.setInt("gNormalSpot", 1);
+        shader.setInt("gDepth", 2);
+        shader.setMat4("invViewProjection", invViewProjection);
+        shader.setVec2("screenSize", glm::vec2((float)width, (float)height));
+    }
+};
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// =================================================================================
+// RITMO DE FRAMES (FRAME PACING)
+// =================================================================================
+//
+//  - Límite opcional de FPS (se cambia en marcha entre TARGET_FPS_STEPS): duerme
+//    hasta ~2 ms antes y termina con espera activa.
+//  - VSync apagado / encendido / adaptativo (swap interval -1 si el driver tiene
+//    *_EXT_swap_control_tear; si no, VSync normal).
+//  - Como mucho MAX_FRAMES_IN_FLIGHT frames en la GPU, usando glFenceSync.
+//  - deltaTime suavizado (promedio de los últimos frames, con tope ante picos).
+//  - Latencia: desde que se leen las entradas hasta el swap (CPU) y hasta que la
+//    GPU termina ese frame (fence), más el tiempo de GPU con GL_TIME_ELAPSED.
+//  - Estadísticas promediadas por intervalo para no tocar el título cada frame.
+
+enum VsyncMode
+{
+    VSYNC_OFF = 0,
+    VSYNC_ON,
+    VSYNC_ADAPTIVE
+};
+
+const int MAX_FRAMES_IN_FLIGHT = 2;
+const int DELTA_SMOOTHING_FRAMES = 8;
+const float MAX_DELTA_TIME = 0.1f;       // Un tirón de carga no teletransporta la moto
+const double HUD_UPDATE_INTERVAL = 0.25; // Segundos entre actualizaciones del título
+const double LIMITER_SPIN_TIME = 0.002;  // Margen final en espera activa
+const double TARGET_FPS_STEPS[] = {0.0, 30.0, 60.0, 120.0, 144.0}; // 0 = sin límite
+const int TARGET_FPS_STEP_COUNT = sizeof(TARGET_FPS_STEPS) / sizeof(TARGET_FPS_STEPS[0]);
+
+// Promedios del último intervalo del HUD, en milisegundos
+struct FrameStats
+{
+    double frameMs = 0.0;
+    double fps = 0.0;
+    double gpuMs = 0.0;
+    double inputToSwapMs = 0.0;
+    double inputToGpuMs = 0.0;
+};
+
+class FramePacer
+{
+public:
+    FramePacer(GLFWwindow *window, double targetFps, VsyncMode vsync)
+        : window(window)
+    {
+        setVsync(vsync);
+        setTargetFps(targetFps);
+        glGenQueries(MAX_FRAMES_IN_FLIGHT, timerQueries);
+        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            fences[i] = 0;
+            inputTime[i] = 0.0;
+            queryPending[i] = false;
+        }
+        for (int i = 0; i < DELTA_SMOOTHING_FRAMES; i++)
+            deltaHistory[i] = 0.0f;
+        lastFrameStart = glfwGetTime();
+        nextFrameTime = lastFrameStart;
+        intervalStart = lastFrameStart;
+    }
+
+    ~FramePacer() { release(); }
+
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    void release()
+    {
+        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            if (fences[i])
+                glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+        if (timerQueries[0])
+            glDeleteQueries(MAX_FRAMES_IN_FLIGHT, timerQueries);
+        timerQueries[0] = 0;
+    }
+
+    void setVsync(VsyncMode mode)
+    {
+        vsync = mode;
+        if (mode == VSYNC_ADAPTIVE && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+            !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+            vsync = VSYNC_ON;
+        glfwSwapInterval(vsync == VSYNC_OFF ? 0 : (vsync == VSYNC_ON ? 1 : -1));
+        std::cout << "VSYNC: " << vsyncName() << std::endl;
+    }
+
+    void cycleVsync() { setVsync(static_cast<VsyncMode>((vsync + 1) % 3)); }
+
+    // 0 = sin límite propio
+    void setTargetFps(double fps)
+    {
+        fpsLimit = fps > 0.0 ? fps : 0.0;
+        nextFrameTime = glfwGetTime();
+        if (fpsLimit > 0.0)
+            std::cout << "LIMITE FPS: " << fpsLimit << std::endl;
+        else
+            std::cout << "LIMITE FPS: ninguno" << std::endl;
+    }
+
+    // Siguiente paso de TARGET_FPS_STEPS (desde uno fuera de la lista vuelve al primero)
+    void cycleTargetFps()
+    {
+        int next = 0;
+        for (int i = 0; i < TARGET_FPS_STEP_COUNT; i++)
+        {
+            if (TARGET_FPS_STEPS[i] == fpsLimit)
+                next = (i + 1) % TARGET_FPS_STEP_COUNT;
+        }
+        setTargetFps(TARGET_FPS_STEPS[next]);
+    }
+
+    double targetFps() const { return fpsLimit; }
+
+    const char *vsyncName() const
+    {
+        return vsync == VSYNC_OFF ? "apagado" : (vsync == VSYNC_ON ? "encendido" : "adaptativo");
+    }
+
+    // Espera por la GPU y por el límite de FPS; calcula deltaTime
+    void beginFrame()
+    {
+        // No dejar que la CPU se adelante más de MAX_FRAMES_IN_FLIGHT frames
+        int slot = frameIndex % MAX_FRAMES_IN_FLIGHT;
+        if (fences[slot])
+        {
+            glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 100000000); // 100 ms
+            retireFence(slot, glfwGetTime());
+        }
+
+        if (fpsLimit > 0.0)
+        {
+            double now = glfwGetTime();
+            double remaining = nextFrameTime - now;
+            if (remaining > LIMITER_SPIN_TIME)
+                std::this_thread::sleep_for(std::chrono::duration<double>(remaining - LIMITER_SPIN_TIME));
+            while (glfwGetTime() < nextFrameTime)
+                ;
+            // Si vamos atrasados no se acumula deuda
+            now = glfwGetTime();
+            nextFrameTime = (nextFrameTime + 1.0 / fpsLimit > now) ? nextFrameTime + 1.0 / fpsLimit : now + 1.0 / fpsLimit;
+        }
+
+        double frameStart = glfwGetTime();
+        rawDelta = static_cast<float>(frameStart - lastFrameStart);
+        lastFrameStart = frameStart;
+
+        float clamped = rawDelta < MAX_DELTA_TIME ? rawDelta : MAX_DELTA_TIME;
+        deltaHistory[frameIndex % DELTA_SMOOTHING_FRAMES] = clamped;
+        int samples = frameIndex + 1 < DELTA_SMOOTHING_FRAMES ? frameIndex + 1 : DELTA_SMOOTHING_FRAMES;
+        float sum = 0.0f;
+        for (int i = 0; i < samples; i++)
+            sum += deltaHistory[i];
+        smoothDelta = sum / samples;
+
+        accumFrame += rawDelta;
+        accumFrames++;
+
+        // Tiempo de GPU del frame que usó este slot antes
+        lastGpuMs = -1.0;
+        if (queryPending[slot])
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timerQueries[slot], GL_QUERY_RESULT, &elapsed);
+            lastGpuMs = elapsed / 1.0e6;
+            accumGpu += lastGpuMs;
+            accumGpuSamples++;
+            queryPending[slot] = false;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, timerQueries[slot]);
+    }
+
+    // Llamar justo después de glfwPollEvents
+    void inputSampled() { inputTime[frameIndex % MAX_FRAMES_IN_FLIGHT] = glfwGetTime(); }
+
+    // Termina el frame: swap, fence y estadísticas
+    void present()
+    {
+        int slot = frameIndex % MAX_FRAMES_IN_FLIGHT;
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[slot] = true;
+
+        glfwSwapBuffers(window);
+        double swapTime = glfwGetTime();
+        accumInputToSwap += (swapTime - inputTime[slot]) * 1000.0;
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        // Revisar sin bloquear si algún frame anterior ya salió de la GPU
+        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            if (i != slot && fences[i] && glClientWaitSync(fences[i], 0, 0) != GL_TIMEOUT_EXPIRED)
+                retireFence(i, swapTime);
+        }
+
+        frameIndex++;
+        hudReady = false;
+        if (swapTime - intervalStart >= HUD_UPDATE_INTERVAL)
+        {
+            stats.frameMs = accumFrame * 1000.0 / accumFrames;
+            stats.fps = accumFrames / (swapTime - intervalStart);
+            stats.inputToSwapMs = accumInputToSwap / accumFrames;
+            if (accumGpuSamples > 0)
+                stats.gpuMs = accumGpu / accumGpuSamples;
+            if (accumGpuDoneSamples > 0)
+                stats.inputToGpuMs = accumInputToGpu / accumGpuDoneSamples;
+            accumFrame = accumGpu = accumInputToSwap = accumInputToGpu = 0.0;
+            accumFrames = accumGpuSamples = accumGpuDoneSamples = 0;
+            intervalStart = swapTime;
+            hudReady = true;
+        }
+    }
+
+    float deltaTime() const { return smoothDelta; }
+    float rawDeltaTime() const { return rawDelta; }
+
+    // GPU del frame de hace MAX_FRAMES_IN_FLIGHT frames (ms), o -1 si no hubo medida
+    double gpuFrameMs() const { return lastGpuMs; }
+
+    // true una vez por intervalo, cuando hay estadísticas nuevas para el título
+    bool hudDue() const { return hudReady; }
+    const FrameStats &frameStats() const { return stats; }
+
+private:
+    GLFWwindow *window;
+    double fpsLimit = 0.0;
+    VsyncMode vsync = VSYNC_ON;
+
+    GLsync fences[MAX_FRAMES_IN_FLIGHT];
+    double inputTime[MAX_FRAMES_IN_FLIGHT];
+    GLuint timerQueries[MAX_FRAMES_IN_FLIGHT] = {0};
+    bool queryPending[MAX_FRAMES_IN_FLIGHT];
+    int frameIndex = 0;
+
+    double lastFrameStart = 0.0, nextFrameTime = 0.0;
+    float rawDelta = 0.0f, smoothDelta = 0.0f;
+    double lastGpuMs = -1.0;
+    float deltaHistory[DELTA_SMOOTHING_FRAMES];
+
+    double intervalStart = 0.0;
+    double accumFrame = 0.0, accumGpu = 0.0, accumInputToSwap = 0.0, accumInputToGpu = 0.0;
+    int accumFrames = 0, accumGpuSamples = 0, accumGpuDoneSamples = 0;
+    bool hudReady = false;
+    FrameStats stats;
+
+    void retireFence(int slot, double now)
+    {
+        accumInputToGpu += (now - inputTime[slot]) * 1000.0;
+        accumGpuDoneSamples++;
+        glDeleteSync(fences[slot]);
+        fences[slot] = 0;
+    }
+};
+
+#endif
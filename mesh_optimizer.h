@@ -0,0 +1,657 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/model.h>
+#include <learnopengl/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// =================================================================================
+// OPTIMIZACIÓN DE MALLAS AL IMPORTAR
+// =================================================================================
+//
+// Convierte un Model de Assimp en un PackedModel:
+//  - Une las submallas que comparten las mismas texturas (un draw por material).
+//  - Cuantiza: posición float, normal 10-10-10-2 y UV en 16 bits: unorm si todas
+//    caben en [0, 1], half-float si su paso no supera medio texel de la textura
+//    más grande del material, y float si no.
+//  - Elimina vértices duplicados después de cuantizar.
+//  - Reordena triángulos para la caché post-transformación (Forsyth) y los vértices
+//    en orden de primer uso.
+//  - Parte cada material en meshlets de hasta 65535 vértices con índices de 16 bits.
+//
+// Todos los meshlets comparten un VAO/VBO/EBO y se dibujan con glDrawElementsBaseVertex.
+// Con MESH_STATS definido cada PackedModel imprime lo que ganó al cocinarse.
+// Las tangentes no se guardan: shader_Examen_B2 no las usa.
+// Las texturas pasan a una TextureCache por ruta; los lotes guardan referencias a
+// ellas, así una textura recargada se ve en todos los modelos sin rearmarlos.
+
+const int VCACHE_SIZE = 32;
+const uint32_t MESHLET_MAX_VERTICES = 65535;
+const float UV_MAX_ERROR_TEXELS = 0.5f;
+
+// Un solo formato por modelo: todos los lotes comparten VAO
+enum UvFormat
+{
+    UV_UNORM16 = 0,
+    UV_HALF,
+    UV_FLOAT
+};
+
+// Vértice cuantizado; solo se suben los primeros 'stride' bytes
+struct PackedVertex
+{
+    float position[3];
+    uint32_t normal;
+    uint32_t uv[2]; // unorm16x2 o half2 en uv[0], o float2 en uv[0..1]
+
+    bool operator==(const PackedVertex &o) const { return std::memcmp(this, &o, sizeof(PackedVertex)) == 0; }
+};
+
+struct PackedVertexHash
+{
+    size_t operator()(const PackedVertex &v) const
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&v);
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < sizeof(PackedVertex); i++)
+            h = (h ^ bytes[i]) * 16777619u;
+        return h;
+    }
+};
+
+// Un meshlet dentro de los buffers compartidos del modelo
+struct PackedDraw
+{
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+};
+
+// Textura de un modelo. El id puede cambiar al recargarla, por eso se lee al
+// dibujar. Se borra con su última referencia.
+struct SharedTexture
+{
+    unsigned int id;
+    std::string path;
+
+    SharedTexture(unsigned int id, const std::string &path) : id(id), path(path) {}
+    ~SharedTexture() { glDeleteTextures(1, &id); }
+
+    SharedTexture(const SharedTexture &) = delete;
+    SharedTexture &operator=(const SharedTexture &) = delete;
+};
+
+// Texturas de modelo por ruta completa. Solo guarda referencias débiles: las
+// mantienen vivas los PackedModel que las usan.
+class TextureCache
+{
+public:
+    // La textura ya cargada de esa ruta, o NULL
+    std::shared_ptr<SharedTexture> find(const std::string &path)
+    {
+        std::map<std::string, std::weak_ptr<SharedTexture>>::iterator it = entries.find(path);
+        if (it == entries.end())
+            return std::shared_ptr<SharedTexture>();
+        std::shared_ptr<SharedTexture> texture = it->second.lock();
+        if (!texture)
+            entries.erase(it);
+        return texture;
+    }
+
+    // Registra una textura recién creada. Si la ruta ya estaba cargada se usa la
+    // existente y la nueva (un duplicado) se borra.
+    std::shared_ptr<SharedTexture> adopt(const std::string &path, unsigned int id)
+    {
+        std::shared_ptr<SharedTexture> texture = find(path);
+        if (texture)
+        {
+            if (id != texture->id)
+                glDeleteTextures(1, &id);
+            return texture;
+        }
+        texture.reset(new SharedTexture(id, path));
+        entries[path] = texture;
+        return texture;
+    }
+
+private:
+    std::map<std::string, std::weak_ptr<SharedTexture>> entries;
+};
+
+// Submallas unidas por material
+struct PackedBatch
+{
+    std::vector<Texture> textures; // tipo + ruta completa (el id solo vale al cocinar)
+    std::vector<PackedDraw> draws;
+    std::vector<std::shared_ptr<SharedTexture>> handles; // Los llena PackedModel, en el orden de textures
+};
+
+// Resultado del cocinado en CPU (sin llamadas a OpenGL)
+struct PackedModelData
+{
+    std::string name;
+    UvFormat uvFormat = UV_UNORM16;
+    uint32_t stride = 0;
+    std::vector<unsigned char> vertexData;
+    std::vector<uint16_t> indices;
+    std::vector<PackedBatch> batches;
+    std::vector<Texture> loadedTextures; // Creadas por el Model, con ruta completa
+
+    // Esfera envolvente en espacio local (para culling)
+    glm::vec3 boundsCenter = glm::vec3(0.0f);
+    float boundsRadius = 0.0f;
+
+    size_t sourceMeshes = 0;
+    size_t sourceVertices = 0;
+    size_t sourceBytes = 0;
+};
+
+// --- CUANTIZACIÓN ---
+inline uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1u) // redondeo
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7C00u);
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000u) // redondeo (puede subir el exponente, es correcto)
+        half++;
+    return static_cast<uint16_t>(half);
+}
+
+inline uint32_t packNormal1010102(glm::vec3 n)
+{
+    float len = glm::length(n);
+    if (len > 0.0f)
+        n = n / len;
+    int32_t x = static_cast<int32_t>(std::round(glm::clamp(n.x, -1.0f, 1.0f) * 511.0f));
+    int32_t y = static_cast<int32_t>(std::round(glm::clamp(n.y, -1.0f, 1.0f) * 511.0f));
+    int32_t z = static_cast<int32_t>(std::round(glm::clamp(n.z, -1.0f, 1.0f) * 511.0f));
+    return (static_cast<uint32_t>(x) & 0x3FFu) | ((static_cast<uint32_t>(y) & 0x3FFu) << 10) | ((static_cast<uint32_t>(z) & 0x3FFu) << 20);
+}
+
+// Paso entre half-floats consecutivos cerca de 'magnitude'
+inline float halfStep(float magnitude)
+{
+    int exponent = 0;
+    std::frexp(magnitude, &exponent); // magnitude = f * 2^exponent, f en [0.5, 1)
+    return std::ldexp(1.0f, std::max(exponent - 1, -14) - 10);
+}
+
+inline uint32_t packUnorm16x2(glm::vec2 uv)
+{
+    uint32_t x = static_cast<uint32_t>(std::round(glm::clamp(uv.x, 0.0f, 1.0f) * 65535.0f));
+    uint32_t y = static_cast<uint32_t>(std::round(glm::clamp(uv.y, 0.0f, 1.0f) * 65535.0f));
+    return x | (y << 16);
+}
+
+inline PackedVertex packVertex(const Vertex &v, UvFormat uvFormat)
+{
+    PackedVertex p;
+    std::memset(&p, 0, sizeof(p));
+    p.position[0] = v.Position.x;
+    p.position[1] = v.Position.y;
+    p.position[2] = v.Position.z;
+    p.normal = packNormal1010102(v.Normal);
+    if (uvFormat == UV_UNORM16)
+        p.uv[0] = packUnorm16x2(v.TexCoords);
+    else if (uvFormat == UV_HALF)
+        p.uv[0] = floatToHalf(v.TexCoords.x) | (static_cast<uint32_t>(floatToHalf(v.TexCoords.y)) << 16);
+    else
+    {
+        std::memcpy(&p.uv[0], &v.TexCoords.x, sizeof(float));
+        std::memcpy(&p.uv[1], &v.TexCoords.y, sizeof(float));
+    }
+    return p;
+}
+
+// --- CACHÉ POST-TRANSFORMACIÓN (Tom Forsyth, "Linear-Speed Vertex Cache Optimisation") ---
+inline float vertexCacheScore(int cachePos, uint32_t remaining)
+{
+    if (remaining == 0)
+        return -1.0f;
+    float score = 0.0f;
+    if (cachePos >= 0)
+    {
+        if (cachePos < 3)
+            score = 0.75f;
+        else
+            score = std::pow(1.0f - (cachePos - 3) / static_cast<float>(VCACHE_SIZE - 3), 1.5f);
+    }
+    return score + 2.0f / std::sqrt(static_cast<float>(remaining));
+}
+
+inline void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+    size_t triCount = indices.size() / 3;
+    if (triCount == 0)
+        return;
+
+    // Triángulos que usa cada vértice
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); i++)
+        remaining[indices[i]]++;
+    std::vector<uint32_t> triOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        triOffset[v + 1] = triOffset[v] + remaining[v];
+    std::vector<uint32_t> triList(indices.size());
+    std::vector<uint32_t> fill(triOffset.begin(), triOffset.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+        triList[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        vScore[v] = vertexCacheScore(-1, remaining[v]);
+
+    std::vector<char> emitted(triCount, 0);
+
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+    std::vector<uint32_t> cache, newCache;
+    size_t scanCursor = 0;
+    int64_t best = -1;
+
+    while (out.size() < indices.size())
+    {
+        // Sin candidatos en caché: siguiente triángulo pendiente
+        if (best < 0)
+        {
+            while (emitted[scanCursor])
+                scanCursor++;
+            best = static_cast<int64_t>(scanCursor);
+        }
+
+        emitted[best] = 1;
+        newCache.clear();
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t v = indices[best * 3 + k];
+            out.push_back(v);
+            newCache.push_back(v);
+
+            // Quitar el triángulo de la lista del vértice
+            uint32_t *list = &triList[triOffset[v]];
+            for (uint32_t j = 0; j < remaining[v]; j++)
+            {
+                if (list[j] == static_cast<uint32_t>(best))
+                {
+                    list[j] = list[remaining[v] - 1];
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+        for (size_t i = 0; i < cache.size(); i++)
+        {
+            uint32_t v = cache[i];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+                newCache.push_back(v);
+        }
+
+        for (size_t i = 0; i < newCache.size(); i++)
+        {
+            uint32_t v = newCache[i];
+            cachePos[v] = (i < static_cast<size_t>(VCACHE_SIZE)) ? static_cast<int>(i) : -1;
+            vScore[v] = vertexCacheScore(cachePos[v], remaining[v]);
+        }
+
+        // Reevaluar los triángulos que tocan la caché y elegir el mejor
+        best = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCache.size(); i++)
+        {
+            uint32_t v = newCache[i];
+            for (uint32_t j = 0; j < remaining[v]; j++)
+            {
+                uint32_t t = triList[triOffset[v] + j];
+                float s = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+                if (s > bestScore)
+                {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+
+        if (newCache.size() > static_cast<size_t>(VCACHE_SIZE))
+            newCache.resize(VCACHE_SIZE);
+        cache.swap(newCache);
+    }
+    indices.swap(out);
+}
+
+// --- COCINADO ---
+inline bool sameTextures(const std::vector<Texture> &a, const std::vector<Texture> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+        if (a[i].id != b[i].id || a[i].type != b[i].type)
+            return false;
+    return true;
+}
+
+inline PackedModelData cookModel(const Model &source, const std::string &name)
+{
+    PackedModelData data;
+    data.name = name;
+    data.sourceMeshes = source.meshes.size();
+    for (size_t t = 0; t < source.textures_loaded.size(); t++)
+    {
+        data.loadedTextures.push_back(source.textures_loaded[t]);
+        data.loadedTextures.back().path = source.directory + "/" + source.textures_loaded[t].path;
+    }
+
+    for (size_t m = 0; m < source.meshes.size(); m++)
+    {
+        data.sourceVertices += source.meshes[m].vertices.size();
+        data.sourceBytes += source.meshes[m].vertices.size() * sizeof(Vertex) + source.meshes[m].indices.size() * sizeof(unsigned int);
+    }
+
+    // Esfera envolvente: centro de la caja, radio al vértice más lejano
+    glm::vec3 lo(1e30f), hi(-1e30f);
+    for (size_t m = 0; m < source.meshes.size(); m++)
+        for (size_t v = 0; v < source.meshes[m].vertices.size(); v++)
+        {
+            lo = glm::min(lo, source.meshes[m].vertices[v].Position);
+            hi = glm::max(hi, source.meshes[m].vertices[v].Position);
+        }
+    if (data.sourceVertices > 0)
+    {
+        data.boundsCenter = (lo + hi) * 0.5f;
+        for (size_t m = 0; m < source.meshes.size(); m++)
+            for (size_t v = 0; v < source.meshes[m].vertices.size(); v++)
+                data.boundsRadius = std::max(data.boundsRadius, glm::length(source.meshes[m].vertices[v].Position - data.boundsCenter));
+    }
+
+    // Agrupar submallas por material
+    std::vector<std::vector<size_t>> groups;
+    for (size_t m = 0; m < source.meshes.size(); m++)
+    {
+        size_t g = 0;
+        while (g < groups.size() && !sameTextures(source.meshes[groups[g][0]].textures, source.meshes[m].textures))
+            g++;
+        if (g == groups.size())
+            groups.push_back(std::vector<size_t>());
+        groups[g].push_back(m);
+    }
+
+    // Formato de UV: el que pide el material más exigente (mayor UV x mayor textura)
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        const std::vector<Texture> &textures = source.meshes[groups[g][0]].textures;
+        int textureSize = 0;
+        for (size_t t = 0; t < textures.size(); t++)
+        {
+            int w = 0, h = 0, comp = 0;
+            std::string path = source.directory + "/" + textures[t].path;
+            if (!stbi_info(path.c_str(), &w, &h, &comp))
+                w = h = 1 << 15; // Tamaño desconocido: suponer lo peor
+            textureSize = std::max(textureSize, std::max(w, h));
+        }
+
+        float maxAbs = 0.0f;
+        bool unit = true;
+        for (size_t k = 0; k < groups[g].size(); k++)
+        {
+            const Mesh &mesh = source.meshes[groups[g][k]];
+            for (size_t v = 0; v < mesh.vertices.size(); v++)
+            {
+                glm::vec2 uv = mesh.vertices[v].TexCoords;
+                maxAbs = std::max(maxAbs, std::max(std::fabs(uv.x), std::fabs(uv.y)));
+                if (uv.x < 0.0f || uv.x > 1.0f || uv.y < 0.0f || uv.y > 1.0f)
+                    unit = false;
+            }
+        }
+
+        UvFormat needed = UV_UNORM16;
+        if (!unit)
+            needed = halfStep(maxAbs) * textureSize <= UV_MAX_ERROR_TEXELS ? UV_HALF : UV_FLOAT;
+        data.uvFormat = std::max(data.uvFormat, needed);
+    }
+    data.stride = data.uvFormat == UV_FLOAT ? 24 : 20;
+
+    uint32_t totalVertices = 0;
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        // Cuantizar y eliminar duplicados en todo el material
+        std::vector<PackedVertex> unique;
+        std::vector<uint32_t> indices;
+        std::unordered_map<PackedVertex, uint32_t, PackedVertexHash> lookup;
+        for (size_t k = 0; k < groups[g].size(); k++)
+        {
+            const Mesh &mesh = source.meshes[groups[g][k]];
+            std::vector<uint32_t> remap(mesh.vertices.size());
+            for (size_t v = 0; v < mesh.vertices.size(); v++)
+            {
+                PackedVertex p = packVertex(mesh.vertices[v], data.uvFormat);
+                std::unordered_map<PackedVertex, uint32_t, PackedVertexHash>::iterator it = lookup.find(p);
+                if (it == lookup.end())
+                {
+                    it = lookup.insert(std::make_pair(p, static_cast<uint32_t>(unique.size()))).first;
+                    unique.push_back(p);
+                }
+                remap[v] = it->second;
+            }
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+            {
+                uint32_t a = remap[mesh.indices[i]], b = remap[mesh.indices[i + 1]], c = remap[mesh.indices[i + 2]];
+                if (a == b || b == c || a == c) // triángulo degenerado tras cuantizar
+                    continue;
+                indices.push_back(a);
+                indices.push_back(b);
+                indices.push_back(c);
+            }
+        }
+        if (indices.empty())
+            continue;
+
+        optimizeVertexCache(indices, unique.size());
+
+        // Meshlets de 16 bits; los vértices quedan en orden de primer uso
+        PackedBatch batch;
+        batch.textures = source.meshes[groups[g][0]].textures;
+        for (size_t t = 0; t < batch.textures.size(); t++)
+            batch.textures[t].path = source.directory + "/" + batch.textures[t].path;
+        std::vector<int32_t> local(unique.size(), -1);
+        std::vector<uint32_t> chunkVertices;
+        PackedDraw draw = {0, static_cast<uint32_t>(data.indices.size()), static_cast<int32_t>(totalVertices)};
+
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            uint32_t fresh = 0;
+            for (int k = 0; k < 3; k++)
+                if (local[indices[i + k]] < 0)
+                    fresh++;
+            if (chunkVertices.size() + fresh > MESHLET_MAX_VERTICES)
+            {
+                batch.draws.push_back(draw);
+                for (size_t v = 0; v < chunkVertices.size(); v++)
+                    local[chunkVertices[v]] = -1;
+                totalVertices += static_cast<uint32_t>(chunkVertices.size());
+                chunkVertices.clear();
+                draw.indexCount = 0;
+                draw.firstIndex = static_cast<uint32_t>(data.indices.size());
+                draw.baseVertex = static_cast<int32_t>(totalVertices);
+            }
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[i + k];
+                if (local[v] < 0)
+                {
+                    local[v] = static_cast<int32_t>(chunkVertices.size());
+                    chunkVertices.push_back(v);
+                    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&unique[v]);
+                    data.vertexData.insert(data.vertexData.end(), bytes, bytes + data.stride);
+                }
+                data.indices.push_back(static_cast<uint16_t>(local[v]));
+            }
+            draw.indexCount += 3;
+        }
+        batch.draws.push_back(draw);
+        totalVertices += static_cast<uint32_t>(chunkVertices.size());
+        data.batches.push_back(batch);
+    }
+    return data;
+}
+
+// Libera los buffers de GPU y los arreglos en CPU del Model original; las texturas
+// pasan a la TextureCache. learnopengl no guarda VBO/EBO públicos, así que se
+// consultan desde el VAO.
+inline void releaseModelBuffers(Model &source)
+{
+    for (size_t m = 0; m < source.meshes.size(); m++)
+    {
+        Mesh &mesh = source.meshes[m];
+        GLint vbo = 0, ebo = 0;
+        glBindVertexArray(mesh.VAO);
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &vbo);
+        glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &ebo);
+        glBindVertexArray(0);
+
+        GLuint buffers[2] = {static_cast<GLuint>(vbo), static_cast<GLuint>(ebo)};
+        glDeleteBuffers(2, buffers);
+        glDeleteVertexArrays(1, &mesh.VAO);
+        std::vector<Vertex>().swap(mesh.vertices);
+        std::vector<unsigned int>().swap(mesh.indices);
+    }
+}
+
+class PackedModel
+{
+public:
+    std::string name;
+    std::vector<PackedBatch> batches;
+    glm::vec3 boundsCenter;
+    float boundsRadius;
+    unsigned int VAO = 0;
+
+    PackedModel(const PackedModelData &data, TextureCache &cache)
+        : name(data.name), batches(data.batches), boundsCenter(data.boundsCenter), boundsRadius(data.boundsRadius)
+    {
+        for (size_t t = 0; t < data.loadedTextures.size(); t++)
+            textures.push_back(cache.adopt(data.loadedTextures[t].path, data.loadedTextures[t].id));
+        for (size_t b = 0; b < batches.size(); b++)
+            for (size_t t = 0; t < batches[b].textures.size(); t++)
+                batches[b].handles.push_back(cache.find(batches[b].textures[t].path));
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, data.vertexData.size(), data.vertexData.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(uint16_t), data.indices.data(), GL_STATIC_DRAW);
+
+        GLsizei stride = static_cast<GLsizei>(data.stride);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void *)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        if (data.uvFormat == UV_UNORM16)
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void *)(4 * sizeof(float)));
+        else if (data.uvFormat == UV_HALF)
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void *)(4 * sizeof(float)));
+        else
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void *)(4 * sizeof(float)));
+        glBindVertexArray(0);
+
+#ifdef MESH_STATS
+        size_t draws = 0;
+        for (size_t b = 0; b < batches.size(); b++)
+            draws += batches[b].draws.size();
+        std::cout << "MALLA " << name << ": " << data.sourceMeshes << " -> " << draws << " draws, "
+                  << data.sourceVertices << " -> " << data.vertexData.size() / data.stride << " vertices, "
+                  << data.sourceBytes / 1024 << " -> " << (data.vertexData.size() + data.indices.size() * sizeof(uint16_t)) / 1024 << " KB"
+                  << (data.uvFormat == UV_UNORM16 ? " (UV unorm16)" : (data.uvFormat == UV_HALF ? " (UV half)" : " (UV float)")) << std::endl;
+#endif
+    }
+
+    ~PackedModel()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+
+    PackedModel(const PackedModel &) = delete;
+    PackedModel &operator=(const PackedModel &) = delete;
+
+    // Mismo esquema de nombres de textura que Mesh::Draw de learnopengl
+    void bindTextures(Shader &shader, const PackedBatch &batch)
+    {
+        unsigned int diffuseNr = 1, specularNr = 1, normalNr = 1, heightNr = 1;
+        for (unsigned int i = 0; i < batch.textures.size(); i++)
+        {
+            glActiveTexture(GL_TEXTURE0 + i);
+            std::string number;
+            const std::string &type = batch.textures[i].type;
+            if (type == "texture_diffuse")
+                number = std::to_string(diffuseNr++);
+            else if (type == "texture_specular")
+                number = std::to_string(specularNr++);
+            else if (type == "texture_normal")
+                number = std::to_string(normalNr++);
+            else if (type == "texture_height")
+                number = std::to_string(heightNr++);
+            glUniform1i(glGetUniformLocation(shader.ID, (type + number).c_str()), i);
+            glBindTexture(GL_TEXTURE_2D, batch.handles[i] ? batch.handles[i]->id : 0);
+        }
+    }
+
+    void Draw(Shader &shader)
+    {
+        glBindVertexArray(VAO);
+        for (size_t b = 0; b < batches.size(); b++)
+        {
+            bindTextures(shader, batches[b]);
+            for (size_t d = 0; d < batches[b].draws.size(); d++)
+            {
+                const PackedDraw &draw = batches[b].draws[d];
+                glDrawElementsBaseVertex(GL_TRIANGLES, draw.indexCount, GL_UNSIGNED_SHORT,
+                                         (void *)(draw.firstIndex * sizeof(uint16_t)), draw.baseVertex);
+            }
+        }
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+private:
+    unsigned int VBO = 0, EBO = 0;
+    std::vector<std::shared_ptr<SharedTexture>> textures; // Todas las del Model, aunque ningún lote las use
+};
+
+#endif
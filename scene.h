@@ -0,0 +1,434 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+// =================================================================================
+// ESCENA: modelos, instancias, colisiones y luces leídos desde un archivo
+// =================================================================================
+//
+// Formato de texto (una directiva por línea, '#' inicia un comentario):
+//
+//   model     <nombre> <ruta> [focoDifuso focoEspecular]
+//   instance  <modelo> <x> <y> <z> <rotY> <escala> [radio offX offZ]
+//   row       <modelo> <x> <y> <zInicio> <zFin> <paso> <rotY> <escala> [radio offX offZ]
+//   pointlight <x> <y> <z> <r> <g> <b>
+//   moon      <x> <y> <z>
+//
+// "row" repite la instancia avanzando en -Z mientras z > zFin (igual que los bucles
+// de la avenida). El radio de colisión se mide en XZ desde posición + (offX, 0, offZ);
+// radio 0 = sin colisión. El modelo "@esfera" es la esfera emisiva de renderSphere().
+//
+// La versión cocinada (<archivo>.bin) guarda los mismos arreglos en binario y se
+// carga con una sola lectura. Guarda la fecha y el tamaño del texto del que salió y
+// se regenera si no coinciden (o si su contenido no es coherente).
+
+const char *const SCENE_ESFERA = "@esfera";
+const uint32_t SCENE_BIN_MAGIC = 0x4353524E; // "NRSC"
+const uint32_t SCENE_BIN_VERSION = 2;
+
+struct SceneData
+{
+    // --- MODELOS (indexados por instModel) ---
+    std::vector<std::string> modelNames;
+    std::vector<std::string> modelPaths;
+    std::vector<glm::vec2> modelSpot;     // Respuesta al faro de la moto (difuso, especular)
+    std::vector<uint32_t> modelFirst;     // Primera instancia del modelo
+    std::vector<uint32_t> modelCount;     // Número de instancias
+
+    // --- INSTANCIAS (SoA, agrupadas por modelo) ---
+    std::vector<uint32_t> instModel;
+    std::vector<glm::vec3> instPositions;
+    std::vector<float> instRotations;     // Grados alrededor de Y
+    std::vector<float> instScales;
+
+    // --- COLISIONES (SoA, solo instancias con radio > 0) ---
+    std::vector<glm::vec3> colliderCenters;
+    std::vector<float> colliderRadii;
+
+    // --- LUCES ---
+    std::vector<glm::vec3> pointLightPositions;
+    std::vector<glm::vec3> pointLightColors;
+    glm::vec3 moonPos = glm::vec3(0.0f, 100.0f, 300.0f);
+};
+
+struct SceneBinHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    int64_t sourceTime;  // st_mtime del texto al cocinar
+    uint64_t sourceSize; // st_size del texto al cocinar
+    uint32_t modelCount;
+    uint32_t instanceCount;
+    uint32_t colliderCount;
+    uint32_t lightCount;
+    uint32_t stringBytes;
+};
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 debe ser compacto");
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "glm::vec2 debe ser compacto");
+
+inline int findSceneModel(const SceneData &scene, const std::string &name)
+{
+    for (size_t i = 0; i < scene.modelNames.size(); i++)
+        if (scene.modelNames[i] == name)
+            return static_cast<int>(i);
+    return -1;
+}
+
+inline bool isSceneEsfera(const SceneData &scene, uint32_t m)
+{
+    return scene.modelPaths[m] == SCENE_ESFERA;
+}
+
+// Instancia tal como aparece en el texto, antes de agruparla por modelo
+struct SceneInstanceDesc
+{
+    uint32_t model;
+    glm::vec3 position;
+    float rotation;
+    float scale;
+    float radius;
+    glm::vec3 colliderOffset;
+};
+
+inline int registerSceneModel(SceneData &scene, const std::string &name, const std::string &path, glm::vec2 spot)
+{
+    int m = findSceneModel(scene, name);
+    if (m >= 0)
+        return m;
+    scene.modelNames.push_back(name);
+    scene.modelPaths.push_back(path);
+    scene.modelSpot.push_back(spot);
+    return static_cast<int>(scene.modelNames.size() - 1);
+}
+
+// Lee el archivo de texto y arma los arreglos SoA
+inline bool parseSceneText(const std::string &path, SceneData &scene)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR ESCENA: no se pudo abrir " << path << std::endl;
+        return false;
+    }
+
+    std::vector<SceneInstanceDesc> descs;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream in(line);
+        std::string directive;
+        if (!(in >> directive))
+            continue;
+
+        bool ok = true;
+        if (directive == "model")
+        {
+            std::string name, modelPath;
+            glm::vec2 spot(0.8f, 0.5f);
+            ok = static_cast<bool>(in >> name >> modelPath);
+            if (ok && (in >> spot.x))
+                ok = static_cast<bool>(in >> spot.y);
+            if (ok)
+                registerSceneModel(scene, name, modelPath, spot);
+        }
+        else if (directive == "instance" || directive == "row")
+        {
+            std::string name;
+            glm::vec3 pos;
+            float zEnd = 0.0f, step = 0.0f, rotY = 0.0f, scale = 1.0f;
+            float radius = 0.0f;
+            glm::vec3 offset(0.0f);
+
+            ok = static_cast<bool>(in >> name >> pos.x >> pos.y >> pos.z);
+            if (ok && directive == "row")
+                ok = static_cast<bool>(in >> zEnd >> step) && step > 0.0f;
+            if (ok)
+                ok = static_cast<bool>(in >> rotY >> scale);
+            if (ok && (in >> radius))
+                ok = static_cast<bool>(in >> offset.x >> offset.z);
+
+            int m = -1;
+            if (ok && name == SCENE_ESFERA)
+                m = registerSceneModel(scene, name, SCENE_ESFERA, glm::vec2(0.0f));
+            else if (ok)
+                m = findSceneModel(scene, name);
+            if (ok && m < 0)
+            {
+                std::cout << "ERROR ESCENA: " << path << ":" << lineNumber << " modelo desconocido '" << name << "'" << std::endl;
+                return false;
+            }
+
+            if (ok)
+            {
+                SceneInstanceDesc d = {static_cast<uint32_t>(m), pos, rotY, scale, radius, offset};
+                if (directive == "instance")
+                    descs.push_back(d);
+                else
+                    for (float z = pos.z; z > zEnd; z -= step)
+                    {
+                        d.position.z = z;
+                        descs.push_back(d);
+                    }
+            }
+        }
+        else if (directive == "pointlight")
+        {
+            glm::vec3 pos, color;
+            ok = static_cast<bool>(in >> pos.x >> pos.y >> pos.z >> color.x >> color.y >> color.z);
+            if (ok)
+            {
+                scene.pointLightPositions.push_back(pos);
+                scene.pointLightColors.push_back(color);
+            }
+        }
+        else if (directive == "moon")
+        {
+            ok = static_cast<bool>(in >> scene.moonPos.x >> scene.moonPos.y >> scene.moonPos.z);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::cout << "ERROR ESCENA: " << path << ":" << lineNumber << " linea invalida: " << line << std::endl;
+            return false;
+        }
+    }
+
+    // Agrupar por modelo para que cada modelo se dibuje con un rango contiguo
+    size_t modelTotal = scene.modelNames.size();
+    scene.modelFirst.assign(modelTotal, 0);
+    scene.modelCount.assign(modelTotal, 0);
+    for (size_t i = 0; i < descs.size(); i++)
+        scene.modelCount[descs[i].model]++;
+    for (size_t m = 1; m < modelTotal; m++)
+        scene.modelFirst[m] = scene.modelFirst[m - 1] + scene.modelCount[m - 1];
+
+    scene.instModel.resize(descs.size());
+    scene.instPositions.resize(descs.size());
+    scene.instRotations.resize(descs.size());
+    scene.instScales.resize(descs.size());
+    std::vector<uint32_t> cursor = scene.modelFirst;
+    for (size_t i = 0; i < descs.size(); i++)
+    {
+        const SceneInstanceDesc &d = descs[i];
+        uint32_t slot = cursor[d.model]++;
+        scene.instModel[slot] = d.model;
+        scene.instPositions[slot] = d.position;
+        scene.instRotations[slot] = d.rotation;
+        scene.instScales[slot] = d.scale;
+        if (d.radius > 0.0f)
+        {
+            scene.colliderCenters.push_back(d.position + d.colliderOffset);
+            scene.colliderRadii.push_back(d.radius);
+        }
+    }
+    return true;
+}
+
+// --- FORMATO COCINADO ---
+template <typename T>
+inline void appendSceneArray(std::vector<char> &blob, const std::vector<T> &v)
+{
+    if (v.empty())
+        return;
+    const char *bytes = reinterpret_cast<const char *>(v.data());
+    blob.insert(blob.end(), bytes, bytes + v.size() * sizeof(T));
+}
+
+template <typename T>
+inline bool readSceneArray(const std::vector<char> &blob, size_t &offset, std::vector<T> &v, size_t count)
+{
+    size_t bytes = count * sizeof(T);
+    if (offset + bytes > blob.size())
+        return false;
+    v.resize(count);
+    if (bytes > 0)
+        std::memcpy(v.data(), blob.data() + offset, bytes);
+    offset += bytes;
+    return true;
+}
+
+inline bool writeSceneBinary(const std::string &path, const SceneData &scene, int64_t sourceTime, uint64_t sourceSize)
+{
+    std::vector<char> strings;
+    for (size_t m = 0; m < scene.modelNames.size(); m++)
+    {
+        strings.insert(strings.end(), scene.modelNames[m].begin(), scene.modelNames[m].end());
+        strings.push_back('\0');
+        strings.insert(strings.end(), scene.modelPaths[m].begin(), scene.modelPaths[m].end());
+        strings.push_back('\0');
+    }
+
+    SceneBinHeader header;
+    std::memset(&header, 0, sizeof(header)); // Relleno determinista
+    header.magic = SCENE_BIN_MAGIC;
+    header.version = SCENE_BIN_VERSION;
+    header.sourceTime = sourceTime;
+    header.sourceSize = sourceSize;
+    header.modelCount = static_cast<uint32_t>(scene.modelNames.size());
+    header.instanceCount = static_cast<uint32_t>(scene.instModel.size());
+    header.colliderCount = static_cast<uint32_t>(scene.colliderRadii.size());
+    header.lightCount = static_cast<uint32_t>(scene.pointLightPositions.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::vector<char> blob(reinterpret_cast<const char *>(&header), reinterpret_cast<const char *>(&header) + sizeof(header));
+    blob.insert(blob.end(), strings.begin(), strings.end());
+    appendSceneArray(blob, scene.modelSpot);
+    appendSceneArray(blob, scene.modelFirst);
+    appendSceneArray(blob, scene.modelCount);
+    appendSceneArray(blob, scene.instModel);
+    appendSceneArray(blob, scene.instPositions);
+    appendSceneArray(blob, scene.instRotations);
+    appendSceneArray(blob, scene.instScales);
+    appendSceneArray(blob, scene.colliderCenters);
+    appendSceneArray(blob, scene.colliderRadii);
+    appendSceneArray(blob, scene.pointLightPositions);
+    appendSceneArray(blob, scene.pointLightColors);
+    const char *moon = reinterpret_cast<const char *>(&scene.moonPos);
+    blob.insert(blob.end(), moon, moon + sizeof(glm::vec3));
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    file.write(blob.data(), blob.size());
+    return static_cast<bool>(file);
+}
+
+// Falla si el archivo está truncado o si los índices no son coherentes
+inline bool readSceneBinary(const std::string &path, SceneData &scene, SceneBinHeader &header)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    std::streamoff size = file.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(SceneBinHeader)))
+        return false;
+
+    // Una sola lectura del archivo completo
+    std::vector<char> blob(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(blob.data(), size))
+        return false;
+
+    std::memcpy(&header, blob.data(), sizeof(header));
+    if (header.magic != SCENE_BIN_MAGIC || header.version != SCENE_BIN_VERSION)
+        return false;
+
+    size_t offset = sizeof(header);
+    if (offset + header.stringBytes > blob.size())
+        return false;
+    const char *str = blob.data() + offset;
+    const char *strEnd = str + header.stringBytes;
+    for (uint32_t m = 0; m < header.modelCount; m++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            const char *end = static_cast<const char *>(std::memchr(str, '\0', strEnd - str));
+            if (end == NULL)
+                return false;
+            (k == 0 ? scene.modelNames : scene.modelPaths).push_back(std::string(str, end));
+            str = end + 1;
+        }
+    }
+    offset += header.stringBytes;
+
+    std::vector<glm::vec3> moon;
+    bool ok = readSceneArray(blob, offset, scene.modelSpot, header.modelCount) &&
+              readSceneArray(blob, offset, scene.modelFirst, header.modelCount) &&
+              readSceneArray(blob, offset, scene.modelCount, header.modelCount) &&
+              readSceneArray(blob, offset, scene.instModel, header.instanceCount) &&
+              readSceneArray(blob, offset, scene.instPositions, header.instanceCount) &&
+              readSceneArray(blob, offset, scene.instRotations, header.instanceCount) &&
+              readSceneArray(blob, offset, scene.instScales, header.instanceCount) &&
+              readSceneArray(blob, offset, scene.colliderCenters, header.colliderCount) &&
+              readSceneArray(blob, offset, scene.colliderRadii, header.colliderCount) &&
+              readSceneArray(blob, offset, scene.pointLightPositions, header.lightCount) &&
+              readSceneArray(blob, offset, scene.pointLightColors, header.lightCount) &&
+              readSceneArray(blob, offset, moon, 1);
+    if (!ok)
+        return false;
+    scene.moonPos = moon[0];
+
+    // Los rangos de cada modelo deben caber en las instancias y agruparlas por modelo
+    for (uint32_t i = 0; i < header.instanceCount; i++)
+    {
+        if (scene.instModel[i] >= header.modelCount)
+            return false;
+    }
+    for (uint32_t m = 0; m < header.modelCount; m++)
+    {
+        if (static_cast<uint64_t>(scene.modelFirst[m]) + scene.modelCount[m] > header.instanceCount)
+            return false;
+        for (uint32_t i = scene.modelFirst[m]; i < scene.modelFirst[m] + scene.modelCount[m]; i++)
+        {
+            if (scene.instModel[i] != m)
+                return false;
+        }
+    }
+    return true;
+}
+
+inline bool sceneFileTime(const std::string &path, time_t &mtime)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+    mtime = info.st_mtime;
+    return true;
+}
+
+// Carga <path>.bin si salió del texto actual (misma fecha y tamaño); si no, lee el
+// texto y vuelve a cocinar
+inline bool loadScene(const std::string &path, SceneData &scene)
+{
+    std::string binPath = path + ".bin";
+    struct stat text;
+    bool hasText = stat(path.c_str(), &text) == 0;
+    int64_t textTime = hasText ? static_cast<int64_t>(text.st_mtime) : 0;
+    uint64_t textSize = hasText ? static_cast<uint64_t>(text.st_size) : 0;
+
+    time_t binTime = 0;
+    if (sceneFileTime(binPath, binTime))
+    {
+        SceneData cooked;
+        SceneBinHeader header;
+        if (!readSceneBinary(binPath, cooked, header))
+            std::cout << "ESCENA: " << binPath << " invalido, se vuelve a cocinar" << std::endl;
+        else if (!hasText || (header.sourceTime == textTime && header.sourceSize == textSize))
+        {
+            scene = cooked;
+            return true;
+        }
+    }
+
+    SceneData parsed;
+    if (!parseSceneText(path, parsed))
+        return false;
+    if (!writeSceneBinary(binPath, parsed, textTime, textSize))
+        std::cout << "ESCENA: no se pudo escribir " << binPath << std::endl;
+    scene = parsed;
+    return true;
+}
+
+#endif
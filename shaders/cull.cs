@@ -0,0 +1,42 @@
+#version 430 core
+layout (local_size_x = 64) in;
+
+// --- INSTANCIAS ESTTICAS (mismo layout que GpuInstance en culling.h) ---
+struct Instance {
+    mat4 model;
+    vec4 sphere;  // xyz = centro en mundo, w = radio
+    uvec4 info;   // x = modelo, y = primera instancia del modelo
+};
+
+layout (std430, binding = 0) readonly buffer Instances { Instance instances[]; };
+layout (std430, binding = 1) writeonly buffer Visible { uint visible[]; };
+layout (std430, binding = 2) buffer Counts { uint counts[]; };
+
+uniform vec4 frustumPlanes[6];
+uniform vec3 viewPos;
+uniform float drawDistance;
+uniform uint instanceCount;
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= instanceCount)
+        return;
+
+    // 1. Esfera contra los 6 planos del frustum
+    vec4 sphere = instances[i].sphere;
+    for (int p = 0; p < 6; p++)
+    {
+        if (dot(frustumPlanes[p].xyz, sphere.xyz) + frustumPlanes[p].w < -sphere.w)
+            return;
+    }
+
+    // 2. Distancia de dibujo (ms all la niebla ya es total)
+    if (distance(viewPos, sphere.xyz) - sphere.w > drawDistance)
+        return;
+
+    // 3. Guardar en la regin del modelo
+    uvec4 info = instances[i].info;
+    uint slot = atomicAdd(counts[info.x], 1u);
+    visible[info.y + slot] = i;
+}
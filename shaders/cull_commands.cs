@@ -0,0 +1,27 @@
+#version 430 core
+layout (local_size_x = 64) in;
+
+// Mismo layout que DrawElementsIndirectCommand
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 2) readonly buffer Counts { uint counts[]; };
+layout (std430, binding = 3) buffer Commands { DrawCommand commands[]; };
+layout (std430, binding = 4) readonly buffer CommandModels { uint commandModel[]; };
+
+uniform uint commandCount;
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= commandCount)
+        return;
+
+    // Cada meshlet se dibuja tantas veces como instancias visibles tenga su modelo
+    commands[i].instanceCount = counts[commandModel[i]];
+}
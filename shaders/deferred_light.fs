@@ -0,0 +1,96 @@
+#version 330 core
+out vec4 FragColor;
+
+// Pasada de pantalla completa del camino diferido: Luna + faro + niebla.
+// Los postes se suman despus con deferred_point.fs.
+
+struct Material {
+    float shininess;
+};
+
+struct DirLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+    float constant;
+    float linear;
+    float quadratic;
+    vec3 ambient;
+    vec3 diffuse;  // No se usa: cada pxel trae su respuesta en el G-buffer
+    vec3 specular; // Igual
+};
+
+// --- G-BUFFER ---
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormalSpot;
+uniform sampler2D gDepth;
+uniform mat4 invViewProjection;
+uniform vec2 screenSize;
+
+// --- UNIFORMS (los mismos que pone setSceneLights) ---
+uniform vec3 viewPos;
+uniform DirLight dirLight;
+uniform SpotLight spotLight;
+uniform Material material;
+uniform vec3 fogColor;
+
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / screenSize;
+    float depth = texture(gDepth, uv).r;
+    if (depth == 1.0)
+        discard; // Cielo: queda el color de la niebla
+
+    // Posicin en el mundo desde la profundidad
+    vec4 world = invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+    vec4 albedoSpec = texture(gAlbedoSpec, uv);
+    vec4 normalSpot = texture(gNormalSpot, uv);
+    vec3 albedo = albedoSpec.rgb;
+    float specMap = albedoSpec.a;
+    vec3 norm = decodeNormal(normalSpot.rg);
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    // A. Luz Direccional (Luna)
+    vec3 lightDir = normalize(-dirLight.direction);
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), material.shininess);
+    vec3 result = dirLight.ambient * albedo + dirLight.diffuse * diff * albedo + dirLight.specular * spec * specMap;
+
+    // C. Spotlight (Faro de la Moto), con la respuesta del modelo
+    lightDir = normalize(spotLight.position - fragPos);
+    diff = max(dot(norm, lightDir), 0.0);
+    spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), material.shininess);
+    float distance = length(spotLight.position - fragPos);
+    float attenuation = 1.0 / (spotLight.constant + spotLight.linear * distance + spotLight.quadratic * (distance * distance));
+    float theta = dot(lightDir, normalize(-spotLight.direction));
+    float epsilon = spotLight.cutOff - spotLight.outerCutOff;
+    float intensity = clamp((theta - spotLight.outerCutOff) / epsilon, 0.0, 1.0);
+    vec3 spot = spotLight.ambient * albedo + normalSpot.b * diff * albedo + normalSpot.a * spec * specMap;
+    result += spot * attenuation * intensity;
+
+    // Niebla (mismos valores que shader_Examen_B2.fs)
+    float fogStart = 200.0;
+    float fogEnd = 4000.0;
+    float visibility = clamp((fogEnd - length(viewPos - fragPos)) / (fogEnd - fogStart), 0.0, 1.0);
+
+    FragColor = vec4(mix(fogColor, result, visibility), 1.0);
+}
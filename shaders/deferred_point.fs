@@ -0,0 +1,76 @@
+#version 330 core
+out vec4 FragColor;
+
+// Volumen de un poste (esfera dibujada con lamp.vs). Se suma a la pasada de
+// deferred_light.fs, ya multiplicado por la visibilidad de la niebla.
+
+struct Material {
+    float shininess;
+};
+
+struct PointLight {
+    vec3 position;
+    float constant;
+    float linear;
+    float quadratic;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+#define NR_POINT_LIGHTS 4
+
+// --- G-BUFFER ---
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormalSpot;
+uniform sampler2D gDepth;
+uniform mat4 invViewProjection;
+uniform vec2 screenSize;
+
+// --- UNIFORMS (los mismos que pone setSceneLights) ---
+uniform vec3 viewPos;
+uniform PointLight pointLights[NR_POINT_LIGHTS];
+uniform Material material;
+uniform int lightIndex; // Qu poste representa este volumen
+
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / screenSize;
+    float depth = texture(gDepth, uv).r;
+    if (depth == 1.0)
+        discard;
+
+    vec4 world = invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+    PointLight light = pointLights[lightIndex];
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    vec4 albedoSpec = texture(gAlbedoSpec, uv);
+    vec3 albedo = albedoSpec.rgb;
+    vec3 norm = decodeNormal(texture(gNormalSpot, uv).rg);
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    // B. Luz Puntual (Poste)
+    vec3 lightDir = normalize(light.position - fragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), material.shininess);
+    vec3 result = (light.ambient * albedo + light.diffuse * diff * albedo + light.specular * spec * albedoSpec.a) * attenuation;
+
+    // Misma niebla que deferred_light.fs: mix(fog, luz, v) = fog * (1 - v) + luz * v
+    float fogStart = 200.0;
+    float fogEnd = 4000.0;
+    float visibility = clamp((fogEnd - length(viewPos - fragPos)) / (fogEnd - fogStart), 0.0, 1.0);
+
+    FragColor = vec4(result * visibility, 1.0);
+}
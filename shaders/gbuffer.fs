@@ -0,0 +1,47 @@
+#version 330 core
+// --- SALIDAS (G-BUFFER, ver deferred.h) ---
+layout (location = 0) out vec4 gAlbedoSpec; // rgb = albedo, a = intensidad especular
+layout (location = 1) out vec4 gNormalSpot; // rg = normal octadrica, b/a = respuesta al faro
+
+// --- ESTRUCTURAS (mismos nombres que shader_Examen_B2.fs) ---
+struct Material {
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+    float shininess;
+};
+
+// Solo la respuesta de cada modelo al faro (el resto se aplica en la pasada de luz)
+struct SpotLight {
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// --- ENTRADAS (Desde Vertex Shader) ---
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform Material material;
+uniform SpotLight spotLight;
+
+// Normal unitaria -> 2 componentes (octaedro desplegado en [-1, 1])
+vec2 octWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 encodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    return n.z >= 0.0 ? n.xy : octWrap(n.xy);
+}
+
+void main()
+{
+    // Las 2 nicas lecturas de textura del fragmento
+    vec3 albedo = texture(material.texture_diffuse1, TexCoords).rgb;
+    vec3 specular = texture(material.texture_specular1, TexCoords).rgb;
+
+    gAlbedoSpec = vec4(albedo, dot(specular, vec3(0.299, 0.587, 0.114)));
+    gNormalSpot = vec4(encodeNormal(normalize(Normal)), spotLight.diffuse.x, spotLight.specular.x);
+}
@@ -0,0 +1,32 @@
+#version 430 core
+
+// --- ATRIBUTOS DE ENTRADA ---
+layout (location = 0) in vec3 aPos;       // Posicin
+layout (location = 1) in vec3 aNormal;    // Normal (para luces)
+layout (location = 2) in vec2 aTexCoords; // Textura
+layout (location = 3) in uint aInstance;  // Instancia visible (escrita por cull.cs)
+
+// --- INSTANCIAS ESTTICAS (mismo layout que en cull.cs) ---
+struct Instance {
+    mat4 model;
+    vec4 sphere;
+    uvec4 info;
+};
+layout (std430, binding = 0) readonly buffer Instances { Instance instances[]; };
+
+// --- SALIDAS HACIA EL FRAGMENT SHADER (igual que shader_Examen_B2.vs) ---
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    mat4 model = instances[aInstance].model;
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    TexCoords = aTexCoords;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}